@@ -21,7 +21,32 @@
 #define CAF_RIAC_ALL_HPP
 
 #include "caf/riac/nexus.hpp"
+#include "caf/riac/sharded_nexus.hpp"
+#include "caf/riac/regional_nexus.hpp"
+#include "caf/riac/snapshot.hpp"
+#include "caf/riac/wire_format.hpp"
+#include "caf/riac/export_format.hpp"
+#include "caf/riac/event_exporter.hpp"
+#include "caf/riac/spsc_ring.hpp"
+#include "caf/riac/trace_rings.hpp"
 #include "caf/riac/probe.hpp"
+#include "caf/riac/config.hpp"
+#include "caf/riac/sampler.hpp"
+#include "caf/riac/topology.hpp"
+#include "caf/riac/proc_stats.hpp"
+#include "caf/riac/event_buffer.hpp"
+#include "caf/riac/traffic_table.hpp"
+#include "caf/riac/flow_control.hpp"
+#include "caf/riac/credit_split.hpp"
+#include "caf/riac/coalescer.hpp"
+#include "caf/riac/subscription_index.hpp"
+#include "caf/riac/state_store.hpp"
+#include "caf/riac/trace_store.hpp"
+#include "caf/riac/ring_buffer.hpp"
+#include "caf/riac/time_series.hpp"
+#include "caf/riac/latency_histogram.hpp"
+#include "caf/riac/metrics_cache.hpp"
+#include "caf/riac/metrics_broker.hpp"
 #include "caf/riac/nexus_proxy.hpp"
 #include "caf/riac/message_types.hpp"
 #include "caf/riac/add_message_types.hpp"
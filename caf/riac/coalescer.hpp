@@ -0,0 +1,70 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2015                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#ifndef CAF_RIAC_COALESCER_HPP
+#define CAF_RIAC_COALESCER_HPP
+
+#include <map>
+#include <cstddef>
+
+#include "caf/node_id.hpp"
+
+#include "caf/riac/message_types.hpp"
+
+namespace caf {
+namespace riac {
+
+/// Collects the latest RAM usage, work load and thread load of each node
+/// between two broadcasts of the nexus, see `riac.coalesce-interval`.
+/// Newer updates replace older ones of the same type and node.
+class coalescer {
+public:
+  void add(const ram_usage& x);
+
+  void add(const work_load& x);
+
+  void add(const thread_load& x);
+
+  /// Drops all pending updates of `nid`.
+  void erase(const node_id& nid);
+
+  /// Passes one batch per node with pending updates to `f` and clears all
+  /// pending updates. Each batch holds at most one event per type.
+  template <class F>
+  void flush(F f) {
+    for (auto& kvp : pending_)
+      f(kvp.second);
+    pending_.clear();
+  }
+
+  /// Returns the number of nodes with pending updates.
+  size_t size() const {
+    return pending_.size();
+  }
+
+private:
+  event_batch& batch(const node_id& nid);
+
+  std::map<node_id, event_batch> pending_;
+};
+
+} // namespace riac
+} // namespace caf
+
+#endif // CAF_RIAC_COALESCER_HPP
@@ -0,0 +1,216 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2015                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#ifndef CAF_RIAC_CONFIG_HPP
+#define CAF_RIAC_CONFIG_HPP
+
+#include <string>
+#include <cstddef>
+#include <cstdint>
+
+#include "caf/actor_system_config.hpp"
+
+namespace caf {
+namespace riac {
+
+/// Tuning parameters for probes and nexus instances.
+struct settings {
+  settings();
+
+  /// Maximum number of events a probe buffers before shipping them.
+  size_t batch_size;
+
+  /// Interval in milliseconds for shipping partially filled batches.
+  size_t flush_interval;
+
+  /// Maximum number of events a probe keeps while it is not connected.
+  size_t max_pending;
+
+  /// Timeout in milliseconds for connecting to the nexus.
+  size_t connect_timeout;
+
+  /// Initial delay in milliseconds before reconnecting to the nexus,
+  /// doubled after each failed attempt.
+  size_t reconnect_delay;
+
+  /// Upper bound for `reconnect_delay` in milliseconds.
+  size_t max_reconnect_delay;
+
+  /// Ships events in the compact wire format instead of `event_batch`.
+  bool compact_wire;
+
+  /// Enables tracing of individual messages.
+  bool trace_messages;
+
+  /// Counts the bytes of messages sent to other nodes by computing their
+  /// BASP payload size. This walks each message once more without
+  /// allocating. Disabling it leaves the byte counters at 0 but keeps
+  /// counting messages. Traced messages always carry their size.
+  bool measure_sizes;
+
+  /// Capacity of the per-thread buffers for message traces.
+  size_t ring_size;
+
+  /// Reports only every n-th message to the nexus.
+  size_t sample_rate;
+
+  /// Maximum number of reported messages per second, 0 means unlimited.
+  size_t max_rate;
+
+  /// Overrides `sample_rate` for individual destination actors.
+  /// Uses the format `id=rate`, e.g., `42=10,43=1000`.
+  std::string sample_rates;
+
+  /// Comma-separated list of actor IDs. Traced messages from or to
+  /// any of these actors include their full content.
+  std::string capture_actors;
+
+  /// Comma-separated list of type names. Traced messages starting with
+  /// an element of any of these types include their full content.
+  std::string capture_types;
+
+  /// Includes the content only for every n-th message that matches
+  /// `capture_actors` or `capture_types`.
+  size_t capture_rate;
+
+  /// Traces 1 out of n requests and their responses on all nodes, which
+  /// allows the nexus to assemble them into spans, 0 disables the
+  /// additional sampling.
+  size_t span_rate;
+
+  /// Maximum number of spans kept by a `nexus_proxy`.
+  size_t trace_store_size;
+
+  /// Number of one-minute rollups of CPU load and RAM usage kept per node by
+  /// a `nexus_proxy`. Each point takes 40 bytes per series.
+  size_t history_minutes;
+
+  /// Number of one-hour rollups of CPU load and RAM usage kept per node by
+  /// a `nexus_proxy`. The defaults add up to about 270 KB per node.
+  size_t history_hours;
+
+  /// Interval in milliseconds for reporting message and byte counters per
+  /// pair of actors and pair of nodes, 0 disables the counters.
+  size_t traffic_interval;
+
+  /// Maximum number of distinct pairs of actors and nodes for counting.
+  size_t traffic_table_size;
+
+  /// Interval in milliseconds for reporting RAM usage and work load,
+  /// 0 disables the reports.
+  size_t stats_interval;
+
+  /// Interval in milliseconds for reporting the CPU usage per thread,
+  /// 0 disables the reports.
+  size_t thread_stats_interval;
+
+  /// Interval in milliseconds for pinging directly connected nodes,
+  /// 0 disables latency measurements.
+  size_t ping_interval;
+
+  /// Size of the payload in bytes for estimating the bandwidth of a
+  /// connection once per report interval, 0 disables bandwidth estimates.
+  /// Each node sends this payload to each of its peers.
+  size_t ping_payload;
+
+  /// Interval in milliseconds for reporting latency percentiles.
+  size_t ping_report_interval;
+
+  /// Interval in milliseconds for measuring the mailbox sojourn time of
+  /// published and profiled actors, 0 disables the measurements.
+  size_t profile_interval;
+
+  /// Comma-separated list of actor IDs to profile in addition to all
+  /// published actors.
+  std::string profile_actors;
+
+  /// Number of actors with the highest sojourn times reported per node.
+  size_t hot_actors;
+
+  /// Interval in milliseconds for reporting the hottest actors.
+  size_t profile_report_interval;
+
+  /// Maximum number of nodes per `state_delta` sent by the nexus.
+  size_t snapshot_chunk_size;
+
+  /// Interval in milliseconds for broadcasting the latest RAM usage, work
+  /// load and thread load of updated nodes to listeners, 0 broadcasts
+  /// every single update. Listeners receive one `event_batch` per node
+  /// and interval.
+  size_t coalesce_interval;
+
+  /// Maximum number of events the nexus queues for a listener that has no
+  /// credit left and uses `drop_oldest_policy`.
+  size_t listener_queue;
+
+  /// Interval in milliseconds for forwarding aggregated events from a
+  /// regional nexus to its upstream nexus.
+  size_t region_interval;
+
+  /// Maximum number of message traces a regional nexus forwards per
+  /// interval, further traces only count as dropped events. 0 forwards
+  /// all traces.
+  size_t region_max_messages;
+
+  /// File for persisting the state of the nexus across restarts,
+  /// an empty path disables snapshots.
+  std::string snapshot_path;
+
+  /// Interval in milliseconds for writing snapshots.
+  size_t snapshot_interval;
+
+  /// Time in milliseconds after a restart until the nexus drops restored
+  /// nodes that did not reconnect.
+  size_t snapshot_grace;
+
+  /// Port for serving the state of the nexus as Prometheus metrics via
+  /// HTTP, 0 disables the endpoint.
+  uint16_t metrics_port;
+
+  /// Size in bytes after which an `event_exporter` starts a new file,
+  /// 0 disables rotation, e.g., for writing to a named pipe.
+  size_t export_file_size;
+
+  /// Number of files kept by an `event_exporter`, 0 keeps all files.
+  size_t export_max_files;
+
+  /// Maximum number of rows per block in exported files.
+  size_t export_block_rows;
+
+  /// Interval in milliseconds for writing pending rows to exported files.
+  size_t export_interval;
+};
+
+/// Extends `actor_system_config` with RIAC-specific options that are
+/// configurable via INI file or CLI in the group "riac".
+class config : public actor_system_config {
+public:
+  config();
+
+  settings riac;
+};
+
+/// Returns the RIAC settings stored in `cfg` if it is a `riac::config`,
+/// otherwise returns the default settings.
+const settings& get_settings(const actor_system_config& cfg);
+
+} // namespace riac
+} // namespace caf
+
+#endif // CAF_RIAC_CONFIG_HPP
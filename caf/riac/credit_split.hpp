@@ -0,0 +1,100 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2015                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#ifndef CAF_RIAC_CREDIT_SPLIT_HPP
+#define CAF_RIAC_CREDIT_SPLIT_HPP
+
+#include <map>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+namespace caf {
+namespace riac {
+
+/// Splits the credit of listeners identified by `Key` across a number of
+/// shards. Half of the credit is split evenly, the other half according
+/// to the events each shard received recently. Hence, a busy shard gets
+/// most of the credit while idle shards still get their share for
+/// listeners that only subscribed to their nodes. The remainder of each
+/// split rotates across shards separately for each listener.
+template <class Key>
+class credit_split {
+public:
+  /// Number of events after which older events count only half.
+  static constexpr uint64_t window = 4096;
+
+  explicit credit_split(size_t num_shards)
+      : events_(num_shards > 0 ? num_shards : 1, 0),
+        total_(0) {
+    // nop
+  }
+
+  /// Counts `n` events routed to shard `i`.
+  void count(size_t i, uint64_t n = 1) {
+    events_[i] += n;
+    total_ += n;
+    if (total_ < window)
+      return;
+    total_ = 0;
+    for (auto& x : events_) {
+      x /= 2;
+      total_ += x;
+    }
+  }
+
+  /// Returns the share of `n` credits for each shard.
+  std::vector<uint32_t> split(const Key& k, uint32_t n) {
+    auto num = events_.size();
+    // each shard weighs `num * events + total + 1`, which sums up to
+    // `num * (2 * total + 1)`, i.e., weights are equal without events
+    auto sum = num * (2 * total_ + 1);
+    std::vector<uint32_t> result(num);
+    uint32_t assigned = 0;
+    for (size_t i = 0; i < num; ++i) {
+      auto weight = num * events_[i] + total_ + 1;
+      result[i] = static_cast<uint32_t>(n * weight / sum);
+      assigned += result[i];
+    }
+    auto& next = next_[k];
+    for (auto rest = n - assigned; rest > 0; --rest) {
+      ++result[next];
+      next = (next + 1) % num;
+    }
+    return result;
+  }
+
+  /// Drops the rotation state of `k`.
+  void erase(const Key& k) {
+    next_.erase(k);
+  }
+
+private:
+  std::vector<uint64_t> events_; // recent events per shard
+  uint64_t total_; // sum of `events_`
+  std::map<Key, size_t> next_; // next shard for the remainder per listener
+};
+
+template <class Key>
+constexpr uint64_t credit_split<Key>::window;
+
+} // namespace riac
+} // namespace caf
+
+#endif // CAF_RIAC_CREDIT_SPLIT_HPP
@@ -0,0 +1,120 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2015                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#ifndef CAF_RIAC_EVENT_BUFFER_HPP
+#define CAF_RIAC_EVENT_BUFFER_HPP
+
+#include <mutex>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+#include "caf/riac/wire_format.hpp"
+#include "caf/riac/message_types.hpp"
+
+namespace caf {
+namespace riac {
+
+/// Collects events produced by a probe and ships them to the nexus
+/// as `event_batch` once `max_size` events are pending or when calling
+/// `flush` explicitly. With `compact` set, events go out as
+/// `compact_batch` whenever possible. While disconnected, the buffer
+/// keeps up to `max_pending` events and drops any further event. The
+/// number of dropped events is reported in the next batch. All member
+/// functions are thread-safe.
+class event_buffer {
+public:
+  event_buffer(node_id source_node, size_t max_size, size_t max_pending,
+               bool compact = false);
+
+  /// Sets the destination for all batches as well as the actor
+  /// batches originate from and ships all pending events.
+  void connect(nexus_type uplink, strong_actor_ptr sender);
+
+  /// Drops the current uplink and starts buffering events.
+  void disconnect();
+
+  /// Returns whether this buffer has a valid uplink.
+  bool connected();
+
+  /// Returns whether `x` is the current uplink. Does not acquire the lock.
+  bool is_uplink(const strong_actor_ptr& x) const;
+
+  /// Returns the number of dropped events since creating this buffer.
+  uint64_t dropped();
+
+  void push(ram_usage x);
+
+  void push(work_load x);
+
+  void push(new_route x);
+
+  void push(new_message x);
+
+  void push(new_actor_published x);
+
+  void push(traffic_delta x);
+
+  void push(route_stats x);
+
+  void push(actor_hotspots x);
+
+  void push(thread_load x);
+
+  /// Adds all traces in `xs` and counts `dropped` traces as lost.
+  void push(std::vector<new_message>& xs, uint64_t dropped);
+
+  /// Sends all pending events to the uplink.
+  void flush();
+
+private:
+  template <class T>
+  void push_impl(std::vector<T>& xs, T& x) {
+    std::unique_lock<std::mutex> guard{mtx_};
+    if (size_ >= max_pending_) {
+      ++dropped_;
+      ++total_dropped_;
+      return;
+    }
+    xs.emplace_back(std::move(x));
+    if (++size_ >= max_size_ && ! uplink_.unsafe())
+      flush_impl();
+  }
+
+  // Ships `batch_`, requires `mtx_` to be locked.
+  void flush_impl();
+
+  std::mutex mtx_;
+  nexus_type uplink_;
+  std::atomic<actor_control_block*> uplink_ptr_;
+  strong_actor_ptr sender_;
+  size_t max_size_;
+  size_t max_pending_;
+  size_t size_;
+  uint64_t dropped_; // since last batch
+  uint64_t total_dropped_;
+  event_batch batch_;
+  bool compact_;
+  wire_encoder encoder_;
+};
+
+} // namespace riac
+} // namespace caf
+
+#endif // CAF_RIAC_EVENT_BUFFER_HPP
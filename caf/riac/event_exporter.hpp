@@ -0,0 +1,63 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2015                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#ifndef CAF_RIAC_EVENT_EXPORTER_HPP
+#define CAF_RIAC_EVENT_EXPORTER_HPP
+
+#include <memory>
+#include <string>
+
+#include "caf/typed_event_based_actor.hpp"
+
+#include "caf/riac/export_format.hpp"
+#include "caf/riac/message_types.hpp"
+
+namespace caf {
+namespace riac {
+
+/// The interface of `event_exporter`, which periodically receives a
+/// `tick_atom` from itself for flushing pending rows.
+using event_exporter_type = listener_type::extend<reacts_to<tick_atom>>;
+
+struct event_exporter_state {
+  std::unique_ptr<export_writer> writer;
+  static const char* name;
+};
+
+/// Writes the events it receives as listener of a nexus to `path` using
+/// an `export_writer`. Opening a named pipe blocks until a reader opens
+/// the other end, i.e., exporters writing to pipes should be spawned
+/// detached. Events without a table in the export format are ignored:
+/// - `node_info`, because columns only store integers, i.e., hostnames
+///   and other strings do not fit into a table
+/// - `node_disconnected`, since the format has no table for node events;
+///   readers notice disconnects by the absence of further rows
+/// - `new_actor_published`, `route_stats`, `actor_hotspots` and
+///   `thread_load`, including thread loads in an `event_batch`
+/// - forwarded traffic and route events of a `traffic_delta`
+/// - `state_delta`, because the exporter keeps no state
+event_exporter_type::behavior_type
+event_exporter(event_exporter_type::stateful_pointer<event_exporter_state>
+                 self,
+               std::string path);
+
+} // namespace riac
+} // namespace caf
+
+#endif // CAF_RIAC_EVENT_EXPORTER_HPP
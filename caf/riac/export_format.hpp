@@ -0,0 +1,204 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2015                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#ifndef CAF_RIAC_EXPORT_FORMAT_HPP
+#define CAF_RIAC_EXPORT_FORMAT_HPP
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <fstream>
+#include <unordered_map>
+#include <initializer_list>
+
+#include "caf/node_id.hpp"
+
+#include "caf/riac/message_types.hpp"
+
+namespace caf {
+namespace riac {
+
+/// Tables of the export format. Each row starts with the columns `time`
+/// in microseconds since epoch and `node`, the node reporting the event.
+/// Node columns refer to `export_reader::node`. The remaining columns are:
+/// - messages: dest_node, source_actor, dest_actor, mid, type_token,
+///   size, received
+/// - actor_traffic: source_actor, dest_node, dest_actor, messages, bytes
+/// - node_traffic: dest_node, messages, bytes
+/// - ram: in_use, available
+/// - load: cpu_load, num_processes, num_actors
+/// - routes: dest, state (0 = lost, 1 = indirect, 2 = direct)
+enum class export_table : uint8_t {
+  nodes, // defines node IDs, never returned by `export_reader`
+  messages,
+  actor_traffic,
+  node_traffic,
+  ram,
+  load,
+  routes,
+  index = 0xFF // starts the footer of a file
+};
+
+constexpr size_t export_tables = 7;
+
+/// Returns the number of columns in `x`.
+size_t column_count(export_table x);
+
+/// Returns the name of column `i` in `x`, e.g., for printing headers.
+const char* column_name(export_table x, size_t i);
+
+/// Locates a block in an export file.
+struct export_block_info {
+  export_table table;
+  uint64_t offset;
+  uint64_t rows;
+  uint64_t min_time;
+  uint64_t max_time;
+};
+
+/// A block of rows stored column by column.
+struct export_block {
+  export_table table;
+  uint64_t rows;
+  std::vector<std::vector<uint64_t>> columns;
+};
+
+/// Writes events into an append-only columnar format. A file starts with
+/// a magic number, followed by blocks of up to `block_rows` rows of a
+/// single table. Each column of a block is stored as consecutive varints
+/// and prefixed with its size, which allows readers to skip columns. Times
+/// are stored as zigzag-encoded deltas. Node IDs are stored in full only
+/// once per file in a block of the `nodes` table. Closing a file appends
+/// an index of all blocks and a fixed-size trailer pointing to the index.
+class export_writer {
+public:
+  /// Writes to `path` if `max_file_size` is 0, e.g., to a named pipe.
+  /// Otherwise, writes to `path.0`, `path.1`, ... and starts a new file at
+  /// the next flush after a file exceeds `max_file_size` bytes, keeping
+  /// only the last `max_files` files unless `max_files` is 0. Numbering
+  /// continues after existing files from a previous run.
+  export_writer(std::string path, size_t max_file_size = 0,
+                size_t max_files = 0, size_t block_rows = 4096);
+
+  ~export_writer();
+
+  export_writer(const export_writer&) = delete;
+
+  export_writer& operator=(const export_writer&) = delete;
+
+  void add(const new_message& x);
+
+  void add(uint64_t time, const traffic_delta& x);
+
+  void add(uint64_t time, const ram_usage& x);
+
+  void add(uint64_t time, const work_load& x);
+
+  void add(uint64_t time, const new_route& x);
+
+  void add(uint64_t time, const route_lost& x);
+
+  /// Writes all pending rows. Returns `false` if the file could not be
+  /// opened or written, in which case pending rows are dropped.
+  bool flush();
+
+  /// Writes all pending rows and the index of the current file.
+  void close();
+
+  /// Returns the path of the file currently written to.
+  std::string current_file() const;
+
+private:
+  using table_buffer = std::vector<std::vector<uint64_t>>;
+
+  void append(export_table t, std::initializer_list<uint64_t> row);
+
+  uint64_t ref(const node_id& x);
+
+  bool open();
+
+  bool write_nodes();
+
+  bool write_block(export_table t);
+
+  bool write(const std::vector<char>& buf);
+
+  std::string path_;
+  size_t max_file_size_;
+  size_t max_files_;
+  size_t block_rows_;
+  size_t seq_;
+  uint64_t offset_;
+  std::ofstream out_;
+  table_buffer tables_[export_tables];
+  std::unordered_map<node_id, uint64_t> ids_;
+  std::vector<node_id> new_nodes_;
+  std::vector<export_block_info> index_;
+  std::vector<char> buf_;
+};
+
+/// Reads files produced by an `export_writer`.
+class export_reader {
+public:
+  export_reader();
+
+  /// Opens `path` and loads its index and node IDs. Files without index,
+  /// e.g., files still being written, are indexed by scanning all blocks.
+  /// Named pipes only support reading the blocks in order via `next`.
+  bool open(const std::string& path);
+
+  /// Returns the index of all blocks, except for node definitions.
+  const std::vector<export_block_info>& blocks() const {
+    return blocks_;
+  }
+
+  /// Returns the node ID for the value `ref` of a node column.
+  const node_id& node(uint64_t ref) const;
+
+  /// Reads block `x` into `out`. Columns that are not selected by the bit
+  /// with their position in `mask` remain empty.
+  bool read(const export_block_info& x, export_block& out,
+            uint64_t mask = ~uint64_t{0});
+
+  /// Reads the next block in file order into `out`. Returns `false`
+  /// at the end of the file or if the file is malformed.
+  bool next(export_block& out, uint64_t mask = ~uint64_t{0});
+
+private:
+  // reads the block at the current position
+  bool read_block(export_block& out, uint64_t mask, bool& done);
+
+  bool read_index();
+
+  bool scan();
+
+  bool read(uint64_t& x);
+
+  std::ifstream in_;
+  bool seekable_;
+  uint64_t pos_;
+  std::vector<node_id> nodes_;
+  std::vector<export_block_info> blocks_;
+  std::vector<char> buf_;
+};
+
+} // namespace riac
+} // namespace caf
+
+#endif // CAF_RIAC_EXPORT_FORMAT_HPP
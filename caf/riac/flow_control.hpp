@@ -0,0 +1,134 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2015                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#ifndef CAF_RIAC_FLOW_CONTROL_HPP
+#define CAF_RIAC_FLOW_CONTROL_HPP
+
+#include <set>
+#include <deque>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+#include "caf/node_id.hpp"
+
+#include "caf/riac/message_types.hpp"
+
+namespace caf {
+namespace riac {
+
+/// Tracks the credit of a single listener and holds back events of type
+/// `T` according to its `overflow_policy`, see `subscription`.
+template <class T>
+class flow_control {
+public:
+  flow_control(uint8_t policy, uint64_t credit, size_t max_queued)
+      : policy_(policy),
+        credit_(credit),
+        max_queued_(max_queued > 0 ? max_queued : 1),
+        dropped_(0) {
+    // nop
+  }
+
+  /// Consumes one credit if the listener may receive an event right away,
+  /// i.e., if it has credit and no queued events.
+  bool consume() {
+    if (credit_ == 0 || ! queue_.empty())
+      return false;
+    --credit_;
+    return true;
+  }
+
+  /// Holds back an event from `nid` after `consume` failed. Creates a
+  /// queued item via `f` only for `drop_oldest_policy`. Returns `false`
+  /// if the listener needs to be disconnected.
+  template <class F>
+  bool hold(const node_id& nid, F f) {
+    switch (policy_) {
+      case drop_oldest_policy:
+        queue_.push_back(f());
+        if (queue_.size() > max_queued_) {
+          queue_.pop_front();
+          ++dropped_;
+        }
+        return true;
+      case coalesce_policy:
+        ++dropped_;
+        dirty_.insert(nid);
+        return true;
+      default:
+        ++dropped_;
+        return false;
+    }
+  }
+
+  /// Adds `n` to the credit. Afterwards, passes queued items to `f` and
+  /// up to `chunk_size` nodes with dropped events at a time to `g` while
+  /// credit lasts. Each call to `f` or `g` costs one credit. The second
+  /// argument to `g` is `true` for the chunk with the last dirty nodes.
+  template <class F, class G>
+  void grant(uint32_t n, size_t chunk_size, F f, G g) {
+    credit_ += n;
+    while (credit_ > 0 && ! queue_.empty()) {
+      f(queue_.front());
+      queue_.pop_front();
+      --credit_;
+    }
+    std::vector<node_id> chunk;
+    while (credit_ > 0 && ! dirty_.empty()) {
+      chunk.clear();
+      auto i = dirty_.begin();
+      while (i != dirty_.end() && chunk.size() < chunk_size) {
+        chunk.push_back(*i);
+        i = dirty_.erase(i);
+      }
+      g(chunk, dirty_.empty());
+      --credit_;
+    }
+  }
+
+  uint8_t policy() const {
+    return policy_;
+  }
+
+  uint64_t credit() const {
+    return credit_;
+  }
+
+  size_t queued() const {
+    return queue_.size();
+  }
+
+  uint64_t dropped() const {
+    return dropped_;
+  }
+
+private:
+  uint8_t policy_;
+  uint64_t credit_;
+  size_t max_queued_;
+  uint64_t dropped_;
+  std::deque<T> queue_; // pending events for `drop_oldest_policy`
+  std::set<node_id> dirty_; // nodes with dropped events for `coalesce_policy`
+};
+
+} // namespace riac
+} // namespace caf
+
+#endif // CAF_RIAC_FLOW_CONTROL_HPP
@@ -0,0 +1,86 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2015                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#ifndef CAF_RIAC_LATENCY_HISTOGRAM_HPP
+#define CAF_RIAC_LATENCY_HISTOGRAM_HPP
+
+#include <array>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+namespace caf {
+namespace riac {
+
+/// Counts durations in fixed, log-linear buckets in the style of HDR
+/// histograms. Values below 4 have a bucket of their own, larger values
+/// split each power of two into 4 buckets, i.e., the relative error stays
+/// below 25%. The last bucket also counts all values beyond its range.
+/// Recording never allocates memory.
+class latency_histogram {
+public:
+  static constexpr size_t sub_buckets = 4;
+
+  static constexpr size_t num_buckets = 96;
+
+  latency_histogram();
+
+  /// Counts `x` in its bucket.
+  void record(uint64_t x);
+
+  /// Resets all counters.
+  void clear();
+
+  /// Returns the number of recorded values.
+  uint64_t count() const {
+    return count_;
+  }
+
+  /// Returns the largest recorded value.
+  uint64_t max() const {
+    return max_;
+  }
+
+  /// Returns the highest value in the bucket containing the `p`-th
+  /// percentile, but never more than `max()`.
+  uint64_t percentile(size_t p) const;
+
+  /// Appends the counter of each bucket to `out`, omitting trailing
+  /// empty buckets.
+  void counts(std::vector<uint64_t>& out) const;
+
+  /// Returns the index of the bucket for `x`.
+  static size_t bucket(uint64_t x);
+
+  /// Returns the smallest value in bucket `i`.
+  static uint64_t lower_bound(size_t i);
+
+  /// Returns the highest value in bucket `i`.
+  static uint64_t upper_bound(size_t i);
+
+private:
+  std::array<uint64_t, num_buckets> buckets_;
+  uint64_t count_;
+  uint64_t max_;
+};
+
+} // namespace riac
+} // namespace caf
+
+#endif // CAF_RIAC_LATENCY_HISTOGRAM_HPP
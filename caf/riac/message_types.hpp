@@ -20,9 +20,12 @@
 #ifndef CAF_RIAC_MESSAGE_TYPES_HPP
 #define CAF_RIAC_MESSAGE_TYPES_HPP
 
+#include <map>
+#include <set>
 #include <string>
 #include <vector>
 #include <cstdint>
+#include <utility>
 
 #include "caf/actor.hpp"
 #include "caf/node_id.hpp"
@@ -34,10 +37,16 @@
 namespace caf {
 namespace riac {
 
+/// Describes the CPUs of a single NUMA node.
 struct cpu_info {
   node_id source_node;
   uint64_t num_cores;
   uint64_t mhz_per_core;
+  uint32_t numa_node;
+  uint64_t l1_cache; // data cache per core in bytes
+  uint64_t l2_cache; // in bytes
+  uint64_t l3_cache; // in bytes
+  std::vector<uint32_t> cpus; // IDs of all logical CPUs
 };
 
 template <class T>
@@ -45,6 +54,11 @@ void serialize(T& in_or_out, cpu_info& x, const unsigned int) {
   in_or_out & x.source_node;
   in_or_out & x.num_cores;
   in_or_out & x.mhz_per_core;
+  in_or_out & x.numa_node;
+  in_or_out & x.l1_cache;
+  in_or_out & x.l2_cache;
+  in_or_out & x.l3_cache;
+  in_or_out & x.cpus;
 }
 
 // send on connect from ActorProbe to ActorNexus
@@ -142,20 +156,186 @@ void serialize(T& in_or_out, route_lost& x, const unsigned int) {
   in_or_out & x.dest;
 }
 
+/// Latency and bandwidth of a direct connection, measured by the probe of
+/// `source_node` with ping messages since its previous report. Round-trip
+/// times are given in microseconds.
+struct route_stats {
+  node_id source_node;
+  node_id dest;
+  uint32_t samples; // number of answered pings
+  uint32_t lost; // number of pings without answer
+  uint64_t rtt_p50;
+  uint64_t rtt_p90;
+  uint64_t rtt_p99;
+  uint64_t rtt_max;
+  uint64_t bandwidth; // in bytes per second, 0 if unknown
+};
+
+template <class T>
+void serialize(T& in_or_out, route_stats& x, const unsigned int) {
+  in_or_out & x.source_node;
+  in_or_out & x.dest;
+  in_or_out & x.samples;
+  in_or_out & x.lost;
+  in_or_out & x.rtt_p50;
+  in_or_out & x.rtt_p90;
+  in_or_out & x.rtt_p99;
+  in_or_out & x.rtt_max;
+  in_or_out & x.bandwidth;
+}
+
+/// A request and its response, assembled from the `new_message` events
+/// of both ends. The client sent the request to the server. Timestamps
+/// are in microseconds since epoch as observed by the respective node, 0
+/// if unknown. Hence, `response_received - request_sent` is the latency
+/// seen by the client, `response_sent - request_received` the time spent
+/// in the server, and the difference between both the time in transit.
+struct span_info {
+  uint64_t trace_id; // ID of the root span
+  uint64_t span_id;
+  uint64_t parent_id; // 0 for root spans
+  node_id client_node;
+  actor_id client;
+  node_id server_node;
+  actor_id server;
+  uint32_t type_token; // of the request
+  uint64_t request_sent;
+  uint64_t request_received;
+  uint64_t response_sent;
+  uint64_t response_received;
+};
+
+template <class T>
+void serialize(T& in_or_out, span_info& x, const unsigned int) {
+  in_or_out & x.trace_id;
+  in_or_out & x.span_id;
+  in_or_out & x.parent_id;
+  in_or_out & x.client_node;
+  in_or_out & x.client;
+  in_or_out & x.server_node;
+  in_or_out & x.server;
+  in_or_out & x.type_token;
+  in_or_out & x.request_sent;
+  in_or_out & x.request_received;
+  in_or_out & x.response_sent;
+  in_or_out & x.response_received;
+}
+
+/// CPU usage of a single thread in the process of a probe.
+struct thread_stats {
+  uint32_t tid;
+  std::string name;
+  uint8_t cpu_load; // in percent of a single core
+  uint32_t processor; // CPU the thread ran on last
+  uint64_t run_delay; // microseconds spent waiting for a CPU
+};
+
+template <class T>
+void serialize(T& in_or_out, thread_stats& x, const unsigned int) {
+  in_or_out & x.tid;
+  in_or_out & x.name;
+  in_or_out & x.cpu_load;
+  in_or_out & x.processor;
+  in_or_out & x.run_delay;
+}
+
+/// CPU usage of all threads in the process of a probe since its previous
+/// report. A high `run_delay` indicates more runnable threads than cores.
+struct thread_load {
+  node_id source_node;
+  uint32_t num_workers; // number of worker threads of the CAF scheduler
+  std::vector<thread_stats> threads;
+};
+
+template <class T>
+void serialize(T& in_or_out, thread_load& x, const unsigned int) {
+  in_or_out & x.source_node;
+  in_or_out & x.num_workers;
+  in_or_out & x.threads;
+}
+
+/// Mailbox sojourn times of a single actor, i.e., the time a message
+/// waits in the mailbox plus the time for processing it. Durations are
+/// given in microseconds.
+struct actor_latency {
+  node_id node;
+  actor_id id;
+  std::string name;
+  uint64_t samples;
+  uint64_t p50;
+  uint64_t p90;
+  uint64_t p99;
+  uint64_t max;
+  std::vector<uint64_t> buckets; // counts per `latency_histogram` bucket
+};
+
+template <class T>
+void serialize(T& in_or_out, actor_latency& x, const unsigned int) {
+  in_or_out & x.node;
+  in_or_out & x.id;
+  in_or_out & x.name;
+  in_or_out & x.samples;
+  in_or_out & x.p50;
+  in_or_out & x.p90;
+  in_or_out & x.p99;
+  in_or_out & x.max;
+  in_or_out & x.buckets;
+}
+
+/// Reports the actors with the highest mailbox sojourn times on a node,
+/// ordered by their 99th percentile. Each report replaces the previous one.
+struct actor_hotspots {
+  node_id source_node;
+  std::vector<actor_latency> actors;
+};
+
+template <class T>
+void serialize(T& in_or_out, actor_hotspots& x, const unsigned int) {
+  in_or_out & x.source_node;
+  in_or_out & x.actors;
+}
+
+/// Compact trace record of a message observed by a probe. The content
+/// of the message is only included if the probe is configured to capture
+/// payloads for the involved actors or message types. Sender and receiver
+/// of a message both report it if they trace it.
 struct new_message {
   node_id source_node;
   node_id dest_node;
   actor_id source_actor;
   actor_id dest_actor;
+  uint64_t mid;
+  uint32_t type_token;
+  uint32_t size; // serialized size of the content in bytes
+  uint64_t timestamp; // in microseconds since epoch
+  bool received; // reported by the probe of `dest_node`
   optional<message> msg;
 };
 
+inline std::string to_string(const new_message& x) {
+  return "new_message" + deep_to_string(std::forward_as_tuple(x.source_node,
+                                                              x.dest_node,
+                                                              x.source_actor,
+                                                              x.dest_actor,
+                                                              x.mid,
+                                                              x.type_token,
+                                                              x.size,
+                                                              x.timestamp,
+                                                              x.received,
+                                                              x.msg));
+}
+
 template <class T>
 void serialize(T& in_or_out, new_message& x, const unsigned int) {
   in_or_out & x.source_node;
   in_or_out & x.dest_node;
   in_or_out & x.source_actor;
   in_or_out & x.dest_actor;
+  in_or_out & x.mid;
+  in_or_out & x.type_token;
+  in_or_out & x.size;
+  in_or_out & x.timestamp;
+  in_or_out & x.received;
   in_or_out & x.msg;
 }
 
@@ -172,28 +352,412 @@ void serialize(T& in_or_out, new_actor_published& x, const unsigned int) {
   in_or_out & x.port;
 }
 
+/// Number of messages and bytes sent from one actor to another.
+struct actor_traffic {
+  node_id source_node;
+  actor_id source_actor;
+  node_id dest_node;
+  actor_id dest_actor;
+  uint64_t messages;
+  uint64_t bytes;
+};
+
+template <class T>
+void serialize(T& in_or_out, actor_traffic& x, const unsigned int) {
+  in_or_out & x.source_node;
+  in_or_out & x.source_actor;
+  in_or_out & x.dest_node;
+  in_or_out & x.dest_actor;
+  in_or_out & x.messages;
+  in_or_out & x.bytes;
+}
+
+/// Number of messages and bytes sent from one node to another.
+struct node_traffic {
+  node_id source_node;
+  node_id dest_node;
+  uint64_t messages;
+  uint64_t bytes;
+};
+
+template <class T>
+void serialize(T& in_or_out, node_traffic& x, const unsigned int) {
+  in_or_out & x.source_node;
+  in_or_out & x.dest_node;
+  in_or_out & x.messages;
+  in_or_out & x.bytes;
+}
+
+/// Number of messages and bytes a node relayed from one node to another
+/// on behalf of others in the BASP routing mesh.
+struct forwarding_traffic {
+  node_id source_node; // the relaying node
+  node_id from;
+  node_id to;
+  uint64_t messages;
+  uint64_t bytes;
+};
+
+template <class T>
+void serialize(T& in_or_out, forwarding_traffic& x, const unsigned int) {
+  in_or_out & x.source_node;
+  in_or_out & x.from;
+  in_or_out & x.to;
+  in_or_out & x.messages;
+  in_or_out & x.bytes;
+}
+
+/// Kinds of events probes count per pair of nodes in `route_events`.
+enum route_event_kind : uint32_t {
+  forwarding_failed = 1, // unable to relay a message on behalf of others
+  sending_failed, // unable to send a message of a local actor
+  invalid_message, // received a message for an unknown actor
+  remote_actor // created a proxy for an actor on another node
+};
+
+/// Number of events of a particular kind observed by a node for messages
+/// from one node to another.
+struct route_events {
+  node_id source_node; // the observing node
+  node_id from;
+  node_id to;
+  uint32_t kind; // a `route_event_kind`
+  uint64_t count;
+  uint64_t bytes; // size of all affected messages
+};
+
+template <class T>
+void serialize(T& in_or_out, route_events& x, const unsigned int) {
+  in_or_out & x.source_node;
+  in_or_out & x.from;
+  in_or_out & x.to;
+  in_or_out & x.kind;
+  in_or_out & x.count;
+  in_or_out & x.bytes;
+}
+
+// send periodically from ActorProbe to ActorNexus, counting all messages
+// the probe's node sent or forwarded since the last traffic_delta
+struct traffic_delta {
+  node_id source_node;
+  uint64_t dropped = 0; // messages not counted due to a full table
+  std::vector<actor_traffic> actors;
+  std::vector<node_traffic> nodes;
+  std::vector<forwarding_traffic> forwarded;
+  std::vector<route_events> events;
+};
+
+template <class T>
+void serialize(T& in_or_out, traffic_delta& x, const unsigned int) {
+  in_or_out & x.source_node;
+  in_or_out & x.dropped;
+  in_or_out & x.actors;
+  in_or_out & x.nodes;
+  in_or_out & x.forwarded;
+  in_or_out & x.events;
+}
+
+/// Bundles events collected by a probe in order to ship them
+/// to the nexus in a single message.
+struct event_batch {
+  node_id source_node;
+  uint64_t dropped; // events lost since the previous batch
+  std::vector<ram_usage> ram;
+  std::vector<work_load> load;
+  std::vector<new_route> routes;
+  std::vector<route_lost> lost_routes;
+  std::vector<new_message> messages;
+  std::vector<new_actor_published> published_actors;
+  std::vector<traffic_delta> traffic;
+  std::vector<route_stats> latencies;
+  std::vector<actor_hotspots> hotspots;
+  std::vector<thread_load> threads;
+};
+
+template <class T>
+void serialize(T& in_or_out, event_batch& x, const unsigned int) {
+  in_or_out & x.source_node;
+  in_or_out & x.dropped;
+  in_or_out & x.ram;
+  in_or_out & x.load;
+  in_or_out & x.routes;
+  in_or_out & x.lost_routes;
+  in_or_out & x.messages;
+  in_or_out & x.published_actors;
+  in_or_out & x.traffic;
+  in_or_out & x.latencies;
+  in_or_out & x.hotspots;
+  in_or_out & x.threads;
+}
+
+/// Events encoded in the compact wire format, see `wire_encoder`. Events
+/// without compact representation still travel in an `event_batch`.
+struct compact_batch {
+  node_id source_node;
+  std::vector<char> data;
+};
+
+template <class T>
+void serialize(T& in_or_out, compact_batch& x, const unsigned int) {
+  in_or_out & x.source_node;
+  in_or_out & x.data;
+}
+
+/// Summarizes the events of all nodes in a region since the previous
+/// summary, see `regional_nexus`. Each node has at most one batch per
+/// representation.
+struct region_summary {
+  std::vector<compact_batch> compact;
+  std::vector<event_batch> batches;
+};
+
+template <class T>
+void serialize(T& in_or_out, region_summary& x, const unsigned int) {
+  in_or_out & x.compact;
+  in_or_out & x.batches;
+}
+
+/// Maps source and destination actor to the accumulated traffic.
+using actor_traffic_map = std::map<std::pair<actor_id,
+                                             std::pair<node_id, actor_id>>,
+                                   actor_traffic>;
+
+/// Maps pairs of nodes to the accumulated forwarding traffic.
+using forwarding_map = std::map<std::pair<node_id, node_id>,
+                                forwarding_traffic>;
+
+/// Maps pairs of nodes and event kinds to the accumulated events.
+using route_events_map = std::map<std::pair<std::pair<node_id, node_id>,
+                                            uint32_t>,
+                                  route_events>;
+
+/// An aggregated sample of a metric, e.g., the CPU load of a node. Raw
+/// samples have a `count` of 1, rollups aggregate all samples in the
+/// interval starting at `timestamp`.
+struct metric_point {
+  uint64_t timestamp; // in milliseconds since epoch
+  uint64_t count;
+  double min;
+  double max;
+  double sum;
+};
+
+template <class T>
+void serialize(T& in_or_out, metric_point& x, const unsigned int) {
+  in_or_out & x.timestamp;
+  in_or_out & x.count;
+  in_or_out & x.min;
+  in_or_out & x.max;
+  in_or_out & x.sum;
+}
+
+/// Throughput and error counters of messages from `from` to `to` that
+/// passed through node `via`, including recent per-second rates.
+struct forwarding_stats {
+  node_id via;
+  node_id from;
+  node_id to;
+  uint64_t messages; // forwarded messages
+  uint64_t bytes; // forwarded bytes
+  uint64_t failures; // failed forwarding and sending attempts
+  double messages_per_sec;
+  double bytes_per_sec;
+  double failures_per_sec;
+};
+
+template <class T>
+void serialize(T& in_or_out, forwarding_stats& x, const unsigned int) {
+  in_or_out & x.via;
+  in_or_out & x.from;
+  in_or_out & x.to;
+  in_or_out & x.messages;
+  in_or_out & x.bytes;
+  in_or_out & x.failures;
+  in_or_out & x.messages_per_sec;
+  in_or_out & x.bytes_per_sec;
+  in_or_out & x.failures_per_sec;
+}
+
 /// Convenience structure to store data collected from probes.
 struct probe_data {
+  uint64_t version; // version of the nexus state at the last modification
   node_info node;
   optional<ram_usage> ram;
   optional<work_load> load;
   std::set<node_id> direct_routes;
   std::set<std::pair<strong_actor_ptr, uint16_t>> published_actors;
   std::set<strong_actor_ptr> known_actors;
+  std::map<node_id, node_traffic> node_traffic_out; // by destination node
+  actor_traffic_map actor_traffic_out; // by source and destination actor
+  forwarding_map forwarded; // relayed on behalf of others
+  route_events_map route_event_counts; // failures and other route events
+  std::map<node_id, route_stats> latencies; // by peer
+  std::vector<actor_latency> hot_actors; // from the last actor_hotspots
+  optional<thread_load> threads;
 };
 
 template <class T>
 void serialize(T& in_or_out, probe_data& x, const unsigned int) {
+  in_or_out & x.version;
   in_or_out & x.node;
   in_or_out & x.ram;
   in_or_out & x.load;
   in_or_out & x.direct_routes;
   in_or_out & x.published_actors;
   in_or_out & x.known_actors;
+  in_or_out & x.node_traffic_out;
+  in_or_out & x.actor_traffic_out;
+  in_or_out & x.forwarded;
+  in_or_out & x.route_event_counts;
+  in_or_out & x.latencies;
+  in_or_out & x.hot_actors;
+  in_or_out & x.threads;
+}
+
+/// Adds the counters of `x` to the accumulated traffic in `nodes`
+/// and `actors`.
+inline void accumulate(std::map<node_id, node_traffic>& nodes,
+                       actor_traffic_map& actors, const traffic_delta& x) {
+  for (auto& y : x.nodes) {
+    auto i = nodes.emplace(y.dest_node, y);
+    if (! i.second) {
+      i.first->second.messages += y.messages;
+      i.first->second.bytes += y.bytes;
+    }
+  }
+  for (auto& y : x.actors) {
+    auto key = std::make_pair(y.source_actor,
+                              std::make_pair(y.dest_node, y.dest_actor));
+    auto i = actors.emplace(key, y);
+    if (! i.second) {
+      i.first->second.messages += y.messages;
+      i.first->second.bytes += y.bytes;
+    }
+  }
+}
+
+/// Adds the forwarding and route event counters of `x` to `forwarded`
+/// and `events`.
+inline void accumulate(forwarding_map& forwarded, route_events_map& events,
+                       const traffic_delta& x) {
+  for (auto& y : x.forwarded) {
+    auto i = forwarded.emplace(std::make_pair(y.from, y.to), y);
+    if (! i.second) {
+      i.first->second.messages += y.messages;
+      i.first->second.bytes += y.bytes;
+    }
+  }
+  for (auto& y : x.events) {
+    auto key = std::make_pair(std::make_pair(y.from, y.to), y.kind);
+    auto i = events.emplace(key, y);
+    if (! i.second) {
+      i.first->second.count += y.count;
+      i.first->second.bytes += y.bytes;
+    }
+  }
+}
+
+/// Adds the counters of `x` to the accumulated traffic in `data`.
+inline void accumulate(probe_data& data, const traffic_delta& x) {
+  accumulate(data.node_traffic_out, data.actor_traffic_out, x);
+  accumulate(data.forwarded, data.route_event_counts, x);
 }
 
 using probe_data_map = std::map<node_id, probe_data>;
 
+/// Transfers the state of the nexus to a listener in one or more chunks.
+/// Listeners apply all chunks in order and then continue with individual
+/// events. A listener can resume from `version` after reconnecting to the
+/// same nexus instance, i.e., with the same `epoch`. Each start of a nexus
+/// begins a new epoch, hence its versions are unrelated to previous runs.
+struct state_delta {
+  uint64_t version; // state version of the nexus at the time of sending
+  uint64_t epoch; // identifies the nexus instance, see `subscription`
+  bool reset; // listeners drop their state before applying the first chunk
+  bool last; // marks the final chunk
+  probe_data_map changed; // nodes modified since the requested version
+  std::vector<node_id> removed; // nodes removed since the requested version
+};
+
+template <class T>
+void serialize(T& in_or_out, state_delta& x, const unsigned int) {
+  in_or_out & x.version;
+  in_or_out & x.epoch;
+  in_or_out & x.reset;
+  in_or_out & x.last;
+  in_or_out & x.changed;
+  in_or_out & x.removed;
+}
+
+/// Applies a chunk of a state transfer from the nexus to `data`.
+inline void apply(probe_data_map& data, state_delta& x) {
+  if (x.reset)
+    data.clear();
+  for (auto& kvp : x.changed)
+    data[kvp.first] = std::move(kvp.second);
+  for (auto& nid : x.removed)
+    data.erase(nid);
+}
+
+/// Flags for selecting event types in a `subscription`.
+enum event_flags : uint32_t {
+  node_info_events = 0x0001,
+  node_disconnected_events = 0x0002,
+  ram_usage_events = 0x0004,
+  work_load_events = 0x0008,
+  new_route_events = 0x0010,
+  route_lost_events = 0x0020,
+  new_message_events = 0x0040,
+  new_actor_published_events = 0x0080,
+  traffic_delta_events = 0x0100,
+  route_stats_events = 0x0200,
+  actor_hotspots_events = 0x0400,
+  thread_load_events = 0x0800,
+  all_events = 0x0FFF
+};
+
+/// Selects how the nexus treats a listener that has no credit left.
+enum overflow_policy : uint8_t {
+  /// Queues up to `riac.listener-queue` events and drops the oldest.
+  drop_oldest_policy,
+  /// Drops events and transfers the latest state of all affected
+  /// nodes as `state_delta` once the listener grants new credit.
+  coalesce_policy,
+  /// Unsubscribes the listener without terminating it.
+  disconnect_policy
+};
+
+/// Selects which events a listener receives from the nexus. Empty fields
+/// do not restrict the selection, e.g., a default-constructed subscription
+/// selects all events. Nodes are selected if they are either listed in
+/// `nodes` or if their hostname matches `hostname_pattern`. The actor IDs
+/// only restrict `new_message` and `new_actor_published` events.
+/// A listener with `credit` receives at most that many events until it
+/// grants more via `credit_atom`, whereas state transfers on registration
+/// do not count. Afterwards, the nexus applies `policy` to its events.
+struct subscription {
+  uint32_t events = 0; // bitmask of `event_flags`
+  std::set<node_id> nodes;
+  std::string hostname_pattern; // supports the wildcards * and ?
+  std::set<actor_id> actors;
+  uint64_t since = 0; // version to resume from, see `state_delta`
+  uint64_t epoch = 0; // epoch of `since`, 0 always starts over
+  uint32_t credit = 0; // initial credit, 0 disables flow control
+  uint8_t policy = drop_oldest_policy; // see `overflow_policy`
+};
+
+template <class T>
+void serialize(T& in_or_out, subscription& x, const unsigned int) {
+  in_or_out & x.events;
+  in_or_out & x.nodes;
+  in_or_out & x.hostname_pattern;
+  in_or_out & x.actors;
+  in_or_out & x.since;
+  in_or_out & x.epoch;
+  in_or_out & x.credit;
+  in_or_out & x.policy;
+}
+
 /// An event sink consuming messages from the probes.
 using sink_type = typed_actor<reacts_to<node_info>,
                               reacts_to<ram_usage>,
@@ -202,13 +766,39 @@ using sink_type = typed_actor<reacts_to<node_info>,
                               reacts_to<route_lost>,
                               reacts_to<new_message>,
                               reacts_to<new_actor_published>,
+                              reacts_to<traffic_delta>,
+                              reacts_to<route_stats>,
+                              reacts_to<actor_hotspots>,
+                              reacts_to<thread_load>,
                               reacts_to<node_disconnected>>;
 
-using listener_type = sink_type::extend<reacts_to<probe_data_map>>;
-
-/// The expected type of the nexus.
-using nexus_type = sink_type::extend<reacts_to<add_atom, actor>,
-                                     reacts_to<add_atom, listener_type>>;
+/// A listener of the nexus. The nexus sends coalesced updates of a node
+/// in a single `event_batch`, see `riac.coalesce-interval`.
+using listener_type = sink_type::extend<reacts_to<event_batch>,
+                                        reacts_to<state_delta>>;
+
+/// Used by listeners to grant credit to the nexus, see `subscription`.
+using credit_atom = atom_constant<atom("credit")>;
+
+/// The expected type of the nexus. Listeners can pass a `subscription` to
+/// filter events and to receive only modifications since the version and
+/// epoch of their last `state_delta`. Passing only a version always
+/// results in a full state transfer, because the epoch is unknown.
+/// Credit is granted either by the listener itself or on its behalf.
+using nexus_type = sink_type::extend<reacts_to<event_batch>,
+                                     reacts_to<compact_batch>,
+                                     reacts_to<region_summary>,
+                                     reacts_to<add_atom, actor>,
+                                     reacts_to<add_atom, actor, uint64_t>,
+                                     reacts_to<add_atom, actor, subscription>,
+                                     reacts_to<add_atom, listener_type>,
+                                     reacts_to<add_atom, listener_type,
+                                               uint64_t>,
+                                     reacts_to<add_atom, listener_type,
+                                               subscription>,
+                                     reacts_to<credit_atom, uint32_t>,
+                                     reacts_to<credit_atom, listener_type,
+                                               uint32_t>>;
 
 } // namespace riac
 } // namespace caf
@@ -0,0 +1,49 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2015                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#ifndef CAF_RIAC_METRICS_BROKER_HPP
+#define CAF_RIAC_METRICS_BROKER_HPP
+
+#include <string>
+
+#include "caf/actor.hpp"
+#include "caf/stateful_actor.hpp"
+
+#include "caf/io/broker.hpp"
+
+namespace caf {
+namespace riac {
+
+struct metrics_worker_state {
+  std::string request;
+  static const char* name;
+};
+
+/// Accepts HTTP connections and forks a `metrics_worker` for each one.
+behavior metrics_server(io::broker* self, actor nexus);
+
+/// Answers any GET request on `hdl` with the metrics of `nexus` in the text
+/// exposition format of Prometheus and closes the connection afterwards.
+behavior metrics_worker(stateful_actor<metrics_worker_state, io::broker>* self,
+                        io::connection_handle hdl, actor nexus);
+
+} // namespace riac
+} // namespace caf
+
+#endif // CAF_RIAC_METRICS_BROKER_HPP
@@ -0,0 +1,68 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2015                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#ifndef CAF_RIAC_METRICS_CACHE_HPP
+#define CAF_RIAC_METRICS_CACHE_HPP
+
+#include <map>
+#include <string>
+#include <vector>
+#include <cstdint>
+
+#include "caf/node_id.hpp"
+
+#include "caf/riac/message_types.hpp"
+
+namespace caf {
+namespace riac {
+
+/// Renders the state of a nexus in the text exposition format of
+/// Prometheus. The samples of each node are kept pre-rendered until the
+/// version of its `probe_data` changes, hence rendering the state of
+/// unchanged nodes only copies strings.
+class metrics_cache {
+public:
+  metrics_cache();
+
+  /// Returns all metrics for `data`, rendering only nodes that were added
+  /// or modified since the last call.
+  const std::string& render(const probe_data_map& data);
+
+  /// Returns the number of cached nodes.
+  size_t size() const {
+    return nodes_.size();
+  }
+
+private:
+  struct entry {
+    uint64_t version;
+    std::vector<std::string> samples; // one line per metric family
+  };
+
+  void render(const node_id& nid, const probe_data& x, entry& out);
+
+  std::map<node_id, entry> nodes_;
+  std::string body_;
+  bool dirty_;
+};
+
+} // namespace riac
+} // namespace caf
+
+#endif // CAF_RIAC_METRICS_CACHE_HPP
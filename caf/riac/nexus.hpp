@@ -22,32 +22,188 @@
 
 #include <map>
 #include <set>
+#include <chrono>
+#include <string>
+#include <utility>
 
 #include "caf/typed_event_based_actor.hpp"
 
+#include "caf/riac/coalescer.hpp"
+#include "caf/riac/wire_format.hpp"
+#include "caf/riac/flow_control.hpp"
 #include "caf/riac/message_types.hpp"
+#include "caf/riac/metrics_cache.hpp"
+#include "caf/riac/subscription_index.hpp"
 
 namespace caf {
 namespace riac {
 
-class nexus : public nexus_type::base {
+/// Used to query the metrics of a nexus in the text exposition
+/// format of Prometheus.
+using metrics_atom = atom_constant<atom("metrics")>;
+
+/// Used by the nexus for broadcasting coalesced updates.
+using coalesce_atom = atom_constant<atom("coalesce")>;
+
+/// The interface of `nexus`, which periodically receives a `tick_atom`
+/// from itself for writing snapshots and a `coalesce_atom` for
+/// broadcasting coalesced updates.
+using nexus_actor_type =
+  nexus_type::extend<reacts_to<tick_atom>,
+                     reacts_to<coalesce_atom>,
+                     replies_to<metrics_atom>::with<std::string>>;
+
+class nexus : public nexus_actor_type::base {
 public:
-  nexus(actor_config& cfg, bool silent);
+  /// Creates a nexus. A shard of a `sharded_nexus` leaves resetting
+  /// listeners and marking the end of a state transfer to the front.
+  nexus(actor_config& cfg, bool silent, bool shard = false);
   behavior_type make_behavior() override;
 
 private:
-  template <class... Ts>
-  void broadcast(Ts&... xs) {
-    for (auto& l : listeners_)
-      send(l, xs...);
+  template <class T>
+  void broadcast(uint32_t flag, const T& x) {
+    listeners_.visit(flag, x.source_node, {}, [&](const listener_type& hdl) {
+      deliver(hdl, x);
+    });
+    disconnect_exceeded();
+  }
+
+  // sends `x` to `hdl` unless it has no credit left
+  template <class T>
+  void deliver(const listener_type& hdl, const T& x) {
+    auto i = flows_.find(hdl);
+    if (i == flows_.end()) {
+      send(hdl, x);
+      return;
+    }
+    auto& f = i->second;
+    if (f.consume())
+      send(hdl, x);
+    else if (! f.hold(x.source_node, [&] { return make_message(x); }))
+      exceeded_.insert(hdl);
   }
 
-  void add(listener_type hdl);
+  // unsubscribes all listeners in `exceeded_`, which is only safe
+  // after visiting the listeners
+  void disconnect_exceeded();
+
+  // adds `n` to the credit of `hdl` and sends pending events
+  void grant(const listener_type& hdl, uint32_t n);
+
+  // appends the counters of all listeners with credit to `out`
+  void render_flows(std::string& out) const;
+
+  void broadcast(const node_info& x);
+
+  void broadcast(const node_disconnected& x);
+
+  void broadcast(const ram_usage& x);
+
+  void broadcast(const work_load& x);
+
+  void broadcast(const new_route& x);
+
+  void broadcast(const route_lost& x);
+
+  void broadcast(const new_message& x);
+
+  void broadcast(const new_actor_published& x);
+
+  void broadcast(const traffic_delta& x);
+
+  void broadcast(const route_stats& x);
+
+  void broadcast(const actor_hotspots& x);
+
+  void broadcast(const thread_load& x);
+
+  void add(listener_type hdl, subscription sub);
+
+  // sends all modifications since `since` to `hdl` in chunks
+  void sync(listener_type& hdl, uint64_t since, uint64_t epoch);
+
+  // returns the entry for `nid` and marks it as modified
+  probe_data& touch(const node_id& nid);
+
+  // removes the entry for `nid`, returns whether an entry was removed
+  bool remove(const node_id& nid);
+
+  // loads the state from the snapshot file
+  void restore();
+
+  // hands a snapshot to the writer if the state changed and drops
+  // restored nodes that did not reconnect in time
+  void tick();
+
+  // serves metrics via HTTP if configured
+  void serve_metrics();
+
+  // sends each listener one batch per node with coalesced updates
+  void flush_dirty();
+
+  void handle(const ram_usage& ram);
+
+  void handle(const work_load& load);
+
+  void handle(const new_actor_published& msg);
+
+  void handle(const new_route& route);
+
+  void handle(const route_lost& route);
+
+  void handle(const new_message& msg);
+
+  void handle(const traffic_delta& td);
+
+  void handle(const route_stats& rs);
+
+  void handle(const actor_hotspots& ah);
+
+  void handle(const thread_load& threads);
+
+  void handle(const event_batch& batch);
+
+  // decodes `x` with the decoder of the current sender and its source node
+  void handle(const compact_batch& x);
 
   bool silent_;
-  std::map<strong_actor_ptr, node_id> probes_;
+  bool shard_;
+  // maps probes and regional nexus instances to the nodes they report on
+  std::map<strong_actor_ptr, std::set<node_id>> probes_;
+  // decodes compact batches, one per connection and source node, because
+  // a regional nexus runs one encoder per node it reports on
+  std::map<std::pair<strong_actor_ptr, node_id>, wire_decoder> decoders_;
   probe_data_map data_;
-  std::set<listener_type> listeners_;
+  subscription_index<listener_type> listeners_;
+  // flow control of listeners with credit, see `subscription`
+  std::map<listener_type, flow_control<message>> flows_;
+  // listeners without credit using `disconnect_policy`
+  std::set<listener_type> exceeded_;
+  size_t max_queued_;
+  uint64_t version_;
+  // random ID of this instance, versions of other instances are unrelated
+  uint64_t epoch_;
+  // removed nodes with the version of their removal
+  std::map<node_id, uint64_t> removed_;
+  // listeners resuming from a version older than this receive a full
+  // snapshot, because we no longer track all removals up to this point
+  uint64_t pruned_version_;
+  size_t chunk_size_;
+  std::string snapshot_path_;
+  size_t snapshot_interval_;
+  // version of the last written snapshot
+  uint64_t snapshot_version_;
+  // writes snapshots in the background, at most one at a time
+  actor snapshot_writer_;
+  bool snapshot_pending_;
+  // nodes restored from a snapshot that did not reconnect yet
+  std::set<node_id> restored_;
+  std::chrono::steady_clock::time_point restore_deadline_;
+  metrics_cache metrics_;
+  size_t coalesce_interval_;
+  // latest updates of each node since the last broadcast
+  coalescer dirty_;
 };
 
 } // namespace riac
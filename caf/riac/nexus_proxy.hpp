@@ -21,6 +21,7 @@
 #define CAF_RIAC_NEXUS_PROXY_HPP
 
 #include <vector>
+#include <utility>
 
 #include "caf/all.hpp"
 #include "caf/riac/all.hpp"
@@ -37,34 +38,88 @@ using get_node = atom_constant<atom("getNode")>;
 /// Used to query all peers of a particular node.
 using list_peers = atom_constant<atom("listPeers")>;
 
+/// Used with `list_peers` to query the latency and bandwidth
+/// of all direct connections of a particular node.
+using latency_atom = atom_constant<atom("latency")>;
+
 /// Used to query system load information on a particular node.
 using get_sys_load = atom_constant<atom("getSysLoad")>;
 
 /// Used to query RAM usage on a particular node.
 using get_ram_usage = atom_constant<atom("getRam")>;
 
+/// Used to query the CPU usage per thread of a particular node.
+using get_thread_load = atom_constant<atom("getThreads")>;
+
 /// Used to query all known actors on a particular node.
 using list_actors = atom_constant<atom("listActors")>;
 
 /// Used to query a single actor on a particular node.
 using get_actor = atom_constant<atom("getActor")>;
 
+/// Used to query the traffic matrix of all nodes or of
+/// all actors on a particular node.
+using get_traffic = atom_constant<atom("getTraffic")>;
+
+/// Used to query the CPU load history of a particular node
+/// in a time range given in milliseconds since epoch.
+using get_load_history = atom_constant<atom("getLoadHst")>;
+
+/// Used to query the RAM usage history of a particular node
+/// in a time range given in milliseconds since epoch.
+using get_ram_history = atom_constant<atom("getRamHst")>;
+
+/// Used to query forwarding throughput and failures of all routes
+/// or of all routes passing through a particular node.
+using get_routes = atom_constant<atom("getRoutes")>;
+
+/// Used to query the actors with the highest mailbox sojourn
+/// times across all nodes.
+using get_slowest = atom_constant<atom("getSlowest")>;
+
+/// Used to query all spans of a particular trace.
+using get_trace = atom_constant<atom("getTrace")>;
+
+/// Used to query the root spans with the highest latency.
+using get_slow_traces = atom_constant<atom("slowTraces")>;
+
 struct nexus_proxy_state {
-  riac::probe_data_map data;
+  state_store store;
+  trace_store traces;
+  // one per sender and source node, see `regional_nexus`
+  std::map<std::pair<strong_actor_ptr, node_id>, wire_decoder> decoders;
   std::list<node_id> visited_nodes;
+  uint64_t version = 0; // version of the last state_delta from the nexus
+  uint64_t epoch = 0; // epoch of the last state_delta from the nexus
+  strong_actor_ptr upstream; // the nexus sending us its state
 };
 
 using nexus_proxy_type =
   nexus_type::extend<
     reacts_to<probe_data_map>,
+    reacts_to<state_delta>,
     replies_to<list_nodes>::with<std::vector<node_id>>,
     replies_to<list_nodes, std::string>::with<std::vector<node_id>>,
     replies_to<get_node, node_id>::with<node_info>,
     replies_to<list_peers, node_id>::with<std::vector<node_id>>,
+    replies_to<list_peers, node_id, latency_atom>
+    ::with<std::vector<route_stats>>,
     replies_to<get_sys_load, node_id>::with<work_load>,
     replies_to<get_ram_usage, node_id>::with<ram_usage>,
+    replies_to<get_thread_load, node_id>::with<thread_load>,
     replies_to<list_actors, node_id>::with<std::vector<strong_actor_ptr>>,
-    replies_to<get_actor, node_id, actor_id>::with<strong_actor_ptr>
+    replies_to<get_actor, node_id, actor_id>::with<strong_actor_ptr>,
+    replies_to<get_traffic>::with<std::vector<node_traffic>>,
+    replies_to<get_traffic, node_id>::with<std::vector<actor_traffic>>,
+    replies_to<get_load_history, node_id, uint64_t, uint64_t>
+    ::with<std::vector<metric_point>>,
+    replies_to<get_ram_history, node_id, uint64_t, uint64_t>
+    ::with<std::vector<metric_point>>,
+    replies_to<get_routes>::with<std::vector<forwarding_stats>>,
+    replies_to<get_routes, node_id>::with<std::vector<forwarding_stats>>,
+    replies_to<get_slowest, uint32_t>::with<std::vector<actor_latency>>,
+    replies_to<get_trace, uint64_t>::with<std::vector<span_info>>,
+    replies_to<get_slow_traces, uint32_t>::with<std::vector<span_info>>
   >;
 
 nexus_proxy_type::behavior_type
@@ -20,6 +20,7 @@
 #ifndef CAF_RIAC_PROBE_HPP
 #define CAF_RIAC_PROBE_HPP
 
+#include <memory>
 #include <string>
 #include <cstdint>
 
@@ -30,6 +31,10 @@
 namespace caf {
 namespace riac {
 
+class event_buffer;
+
+class trace_rings;
+
 class probe : public actor_system::module {
 public:
   probe(actor_system& sys);
@@ -52,7 +57,14 @@ private:
   actor_system& system_;
   std::string nexus_host_;
   uint16_t nexus_port_;
-  nexus_type uplink_;
+  actor connector_;
+  actor flusher_;
+  actor collector_;
+  actor ping_responder_;
+  actor pinger_;
+  actor profiler_;
+  std::shared_ptr<event_buffer> buf_;
+  std::shared_ptr<trace_rings> rings_;
 };
 
 } // namespace riac
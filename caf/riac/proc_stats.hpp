@@ -0,0 +1,89 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2015                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#ifndef CAF_RIAC_PROC_STATS_HPP
+#define CAF_RIAC_PROC_STATS_HPP
+
+#include <chrono>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <unordered_map>
+
+#include "caf/riac/message_types.hpp"
+
+namespace caf {
+namespace riac {
+
+/// Reads system statistics from `/proc/meminfo`, `/proc/stat` and
+/// `/proc/loadavg` as well as per-thread statistics from
+/// `/proc/self/task`. Keeps all system-wide files open and reuses a single
+/// buffer in order to make periodic sampling as cheap as possible.
+/// Statistics are only available on Linux, all reads fail on other
+/// platforms.
+class proc_stats {
+public:
+  proc_stats();
+
+  ~proc_stats();
+
+  proc_stats(const proc_stats&) = delete;
+  proc_stats& operator=(const proc_stats&) = delete;
+
+  /// Stores RAM usage in bytes into `x`, leaving the source node untouched.
+  bool read(ram_usage& x);
+
+  /// Stores CPU load and number of processes into `x`, leaving source
+  /// node and number of actors untouched. The CPU load is computed
+  /// relative to the previous call, i.e., the first call reports the
+  /// average load since booting the system.
+  bool read(work_load& x);
+
+  /// Stores the CPU usage of each thread of this process into `x`,
+  /// leaving source node and number of workers untouched. Like the CPU
+  /// load in `work_load`, usage is relative to the previous call.
+  bool read(thread_load& x);
+
+private:
+  // CPU times of a thread at the previous call
+  struct thread_sample {
+    uint64_t ticks; // user and system time in clock ticks
+    uint64_t run_delay; // in nanoseconds
+  };
+
+  // reads `path` into `buf_`, returns the number of bytes read
+  size_t read_file(const char* path);
+
+  // reads the content of `fd` into `buf_`, returns the number of bytes read
+  size_t read_file(int fd);
+
+  int meminfo_;
+  int stat_;
+  int loadavg_;
+  std::vector<char> buf_;
+  uint64_t prev_total_;
+  uint64_t prev_idle_;
+  std::unordered_map<uint32_t, thread_sample> prev_threads_;
+  std::chrono::steady_clock::time_point prev_time_;
+};
+
+} // namespace riac
+} // namespace caf
+
+#endif // CAF_RIAC_PROC_STATS_HPP
@@ -0,0 +1,130 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2015                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#ifndef CAF_RIAC_REGIONAL_NEXUS_HPP
+#define CAF_RIAC_REGIONAL_NEXUS_HPP
+
+#include <map>
+#include <set>
+#include <vector>
+#include <utility>
+#include <unordered_map>
+
+#include "caf/typed_event_based_actor.hpp"
+
+#include "caf/riac/wire_format.hpp"
+#include "caf/riac/message_types.hpp"
+
+namespace caf {
+namespace riac {
+
+/// The interface of a regional nexus, which periodically
+/// receives a `tick_atom` from itself for forwarding events.
+using regional_nexus_type = nexus_type::extend<reacts_to<tick_atom>>;
+
+/// Aggregates events from local probes and forwards a summary to an
+/// upstream nexus once per `riac.region-interval`. In the summary, load and
+/// RAM usage only include the latest values, traffic counters are summed
+/// up, and routes that were added and lost again cancel out. Message
+/// traces are forwarded up to `riac.region-max-messages` per interval,
+/// the remaining traces count as dropped events of their node. Node infos
+/// and disconnects are forwarded immediately. Each interval results in a
+/// single `region_summary` with one batch per node, which a
+/// `sharded_nexus` upstream splits across its shards. Since a regional
+/// nexus is a sink itself, regions can be nested. Listeners registering
+/// at a regional nexus are delegated to the upstream nexus.
+class regional_nexus : public regional_nexus_type::base {
+public:
+  regional_nexus(actor_config& cfg, bool silent, nexus_type upstream);
+
+  behavior_type make_behavior() override;
+
+private:
+  // pending events of a single node since the last tick
+  struct pending {
+    optional<ram_usage> ram;
+    optional<work_load> load;
+    std::set<node_id> added_routes;
+    std::set<node_id> lost_routes;
+    std::vector<new_message> messages;
+    std::vector<new_actor_published> published_actors;
+    std::map<node_id, node_traffic> node_traffic_out;
+    actor_traffic_map actor_traffic_out;
+    forwarding_map forwarded;
+    route_events_map route_event_counts;
+    uint64_t traffic_dropped = 0;
+    uint64_t dropped = 0; // events, including traces we did not forward
+    std::map<node_id, route_stats> latencies;
+    optional<actor_hotspots> hotspots;
+    optional<thread_load> threads;
+  };
+
+  void add(const ram_usage& x);
+
+  void add(const work_load& x);
+
+  void add(const new_route& x);
+
+  void add(const route_lost& x);
+
+  void add(const new_message& x);
+
+  void add(const new_actor_published& x);
+
+  void add(const traffic_delta& x);
+
+  void add(const route_stats& x);
+
+  void add(const actor_hotspots& x);
+
+  void add(const thread_load& x);
+
+  void add(const event_batch& x);
+
+  // decodes `x` with the decoder of the current sender and its source node
+  void add(const compact_batch& x);
+
+  // sends all pending events upstream
+  void flush();
+
+  // adds the events of a single node to `out`
+  void append(region_summary& out, event_batch& batch);
+
+  // drops the per-node state of a disconnected node
+  void remove(const strong_actor_ptr& src, const node_id& nid);
+
+  bool silent_;
+  nexus_type upstream_;
+  size_t interval_;
+  bool compact_;
+  size_t max_messages_;
+  // number of traces forwarded in the current interval
+  size_t num_messages_;
+  // one session per node, because shards upstream only see their nodes
+  std::unordered_map<node_id, wire_encoder> encoders_;
+  // maps local probes and nested regions to the nodes they report on
+  std::map<strong_actor_ptr, std::set<node_id>> probes_;
+  std::map<std::pair<strong_actor_ptr, node_id>, wire_decoder> decoders_;
+  std::unordered_map<node_id, pending> pending_;
+};
+
+} // namespace riac
+} // namespace caf
+
+#endif // CAF_RIAC_REGIONAL_NEXUS_HPP
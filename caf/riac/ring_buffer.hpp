@@ -0,0 +1,92 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2015                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#ifndef CAF_RIAC_RING_BUFFER_HPP
+#define CAF_RIAC_RING_BUFFER_HPP
+
+#include <vector>
+#include <cstddef>
+
+namespace caf {
+namespace riac {
+
+/// A circular buffer with fixed capacity that overwrites its oldest
+/// element when full. All storage is allocated at construction time.
+template <class T>
+class ring_buffer {
+public:
+  explicit ring_buffer(size_t capacity)
+      : buf_(capacity > 0 ? capacity : 1),
+        first_(0),
+        size_(0) {
+    // nop
+  }
+
+  void push_back(const T& x) {
+    buf_[(first_ + size_) % buf_.size()] = x;
+    if (size_ < buf_.size())
+      ++size_;
+    else
+      first_ = (first_ + 1) % buf_.size();
+  }
+
+  /// Returns the `i`-th element, whereas 0 is the oldest element.
+  const T& operator[](size_t i) const {
+    return buf_[(first_ + i) % buf_.size()];
+  }
+
+  const T& front() const {
+    return (*this)[0];
+  }
+
+  const T& back() const {
+    return (*this)[size_ - 1];
+  }
+
+  void clear() {
+    first_ = 0;
+    size_ = 0;
+  }
+
+  size_t size() const {
+    return size_;
+  }
+
+  size_t capacity() const {
+    return buf_.size();
+  }
+
+  bool empty() const {
+    return size_ == 0;
+  }
+
+  bool full() const {
+    return size_ == buf_.size();
+  }
+
+private:
+  std::vector<T> buf_;
+  size_t first_;
+  size_t size_;
+};
+
+} // namespace riac
+} // namespace caf
+
+#endif // CAF_RIAC_RING_BUFFER_HPP
@@ -0,0 +1,88 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2015                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#ifndef CAF_RIAC_SAMPLER_HPP
+#define CAF_RIAC_SAMPLER_HPP
+
+#include <map>
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <cstddef>
+
+#include "caf/fwd.hpp"
+
+#include "caf/riac/config.hpp"
+
+namespace caf {
+namespace riac {
+
+/// Decides which messages a probe reports to the nexus. A message passes
+/// if it is the n-th message to its destination, where n is either the
+/// rate configured for this particular actor or the global rate, and if
+/// the token bucket limiting the messages per second is not empty.
+class sampler {
+public:
+  using clock_type = std::chrono::steady_clock;
+
+  /// Creates a sampler selecting 1 out of `rate` messages with at most
+  /// `max_rate` messages per second, whereas 0 disables the limit.
+  /// The map `rates` overrides `rate` for individual destinations.
+  sampler(size_t rate, size_t max_rate,
+          const std::map<actor_id, size_t>& rates);
+
+  /// Creates a sampler from `riac.sample-rate`, `riac.max-rate`
+  /// and `riac.sample-rates`.
+  explicit sampler(const settings& cfg);
+
+  /// Returns whether a message to `dest` gets reported.
+  bool select(actor_id dest, clock_type::time_point now = clock_type::now());
+
+  /// Returns the number of messages rejected so far.
+  size_t dropped() const;
+
+  /// Parses a list of per-actor rates in the format `id=rate,...`.
+  static std::map<actor_id, size_t> parse_rates(const std::string& str);
+
+private:
+  struct counter {
+    counter(size_t n) : rate(n > 0 ? n : 1), count(0) {
+      // nop
+    }
+    size_t rate;
+    std::atomic<size_t> count;
+  };
+
+  bool take_token(clock_type::time_point now);
+
+  counter global_;
+  std::map<actor_id, counter> per_actor_;
+  std::atomic<size_t> dropped_;
+  // token bucket state, only used if `max_rate_ > 0`
+  double max_rate_;
+  std::mutex mtx_;
+  double tokens_;
+  clock_type::time_point last_refill_;
+};
+
+} // namespace riac
+} // namespace caf
+
+#endif // CAF_RIAC_SAMPLER_HPP
@@ -0,0 +1,81 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2015                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#ifndef CAF_RIAC_SHARDED_NEXUS_HPP
+#define CAF_RIAC_SHARDED_NEXUS_HPP
+
+#include <vector>
+
+#include "caf/typed_event_based_actor.hpp"
+
+#include "caf/riac/credit_split.hpp"
+#include "caf/riac/message_types.hpp"
+
+namespace caf {
+namespace riac {
+
+/// A drop-in replacement for `nexus` that partitions probes by node ID
+/// across several `nexus` shards. The front only forwards events to the
+/// shard owning the source node, hence ingest scales with the number of
+/// cores. Batches must only contain events of their source node, which
+/// holds for probes as well as for a `regional_nexus`. The front splits
+/// the summary of a region into one summary per shard. Listeners register
+/// at the front, which merges the state transfers of all shards into a
+/// single one. Listeners cannot resume from a version, because each shard
+/// versions its state independently. The front splits the credit of a
+/// listener across all shards according to the events it forwarded to
+/// each shard, see `credit_split`. A shard may still hold back events
+/// while others have credit left. Each shard starts with at least one
+/// credit, because a credit of 0 disables flow control.
+class sharded_nexus : public nexus_type::base {
+public:
+  sharded_nexus(actor_config& cfg, bool silent, size_t num_shards);
+
+  behavior_type make_behavior() override;
+
+private:
+  // returns the index of the shard owning `nid`
+  size_t index(const node_id& nid) const;
+
+  // forwards the nodes of a region to their shards, with the original
+  // sender for decoding compact batches
+  void split(region_summary& x);
+
+  template <class T>
+  void forward(T& x) {
+    auto i = index(x.source_node);
+    credits_.count(i);
+    delegate(shards_[i], std::move(x));
+  }
+
+  void add(listener_type hdl, subscription sub);
+
+  // sends a share of `n` credits to each shard
+  void grant(const listener_type& hdl, uint32_t n);
+
+  bool silent_;
+  size_t num_shards_;
+  std::vector<nexus_type> shards_;
+  credit_split<listener_type> credits_;
+};
+
+} // namespace riac
+} // namespace caf
+
+#endif // CAF_RIAC_SHARDED_NEXUS_HPP
@@ -0,0 +1,57 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2015                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#ifndef CAF_RIAC_SNAPSHOT_HPP
+#define CAF_RIAC_SNAPSHOT_HPP
+
+#include <string>
+#include <vector>
+#include <cstdint>
+
+#include "caf/fwd.hpp"
+#include "caf/behavior.hpp"
+
+#include "caf/riac/message_types.hpp"
+
+namespace caf {
+namespace riac {
+
+/// Serializes `data` in the snapshot format, omitting all actor handles.
+std::vector<char> serialize_snapshot(actor_system& sys, uint64_t version,
+                                     const probe_data_map& data);
+
+/// Writes the serialized snapshot `buf` to the file at `path`. The file
+/// gets replaced atomically only after its content reached the disk, i.e.,
+/// readers never see a partially written snapshot.
+bool write_snapshot(const std::string& path, const std::vector<char>& buf);
+
+/// Writes each serialized snapshot it receives to `path` and replies
+/// whether it succeeded. Blocks on I/O and hence needs to run detached.
+behavior snapshot_writer(event_based_actor* self, std::string path);
+
+/// Maps the snapshot file at `path` into memory and restores its content
+/// to `data` and `version`. Returns `false` if the file does not exist,
+/// has an incompatible format, or is corrupted.
+bool read_snapshot(actor_system& sys, const std::string& path,
+                   uint64_t& version, probe_data_map& data);
+
+} // namespace riac
+} // namespace caf
+
+#endif // CAF_RIAC_SNAPSHOT_HPP
@@ -0,0 +1,94 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2015                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#ifndef CAF_RIAC_SPSC_RING_HPP
+#define CAF_RIAC_SPSC_RING_HPP
+
+#include <atomic>
+#include <memory>
+#include <cstddef>
+
+namespace caf {
+namespace riac {
+
+/// A bounded, lock-free queue for exactly one producer and one consumer.
+/// All slots are allocated at construction time and the capacity is
+/// rounded up to the next power of two.
+template <class T>
+class spsc_ring {
+public:
+  explicit spsc_ring(size_t capacity)
+      : mask_(round_up(capacity) - 1),
+        slots_(new T[mask_ + 1]),
+        head_(0),
+        tail_(0) {
+    // nop
+  }
+
+  spsc_ring(const spsc_ring&) = delete;
+  spsc_ring& operator=(const spsc_ring&) = delete;
+
+  /// Appends `x` unless the ring is full. Must only be called
+  /// by the producer.
+  bool push(T&& x) {
+    auto t = tail_.load(std::memory_order_relaxed);
+    if (t - head_.load(std::memory_order_acquire) > mask_)
+      return false;
+    slots_[t & mask_] = std::move(x);
+    tail_.store(t + 1, std::memory_order_release);
+    return true;
+  }
+
+  /// Calls `f` for each element in FIFO order and removes all visited
+  /// elements. Must only be called by the consumer.
+  template <class F>
+  size_t drain(F f) {
+    auto h = head_.load(std::memory_order_relaxed);
+    auto t = tail_.load(std::memory_order_acquire);
+    for (auto i = h; i != t; ++i)
+      f(std::move(slots_[i & mask_]));
+    head_.store(t, std::memory_order_release);
+    return t - h;
+  }
+
+  size_t capacity() const {
+    return mask_ + 1;
+  }
+
+private:
+  static size_t round_up(size_t x) {
+    size_t result = 1;
+    while (result < x)
+      result <<= 1;
+    return result;
+  }
+
+  size_t mask_;
+  std::unique_ptr<T[]> slots_;
+  // keep producer and consumer on separate cache lines
+  char pad0_[64];
+  std::atomic<size_t> head_;
+  char pad1_[64];
+  std::atomic<size_t> tail_;
+};
+
+} // namespace riac
+} // namespace caf
+
+#endif // CAF_RIAC_SPSC_RING_HPP
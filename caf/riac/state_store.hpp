@@ -0,0 +1,186 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2015                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#ifndef CAF_RIAC_STATE_STORE_HPP
+#define CAF_RIAC_STATE_STORE_HPP
+
+#include <map>
+#include <string>
+#include <functional>
+#include <vector>
+#include <utility>
+#include <unordered_map>
+
+#include "caf/node_id.hpp"
+
+#include "caf/riac/time_series.hpp"
+#include "caf/riac/message_types.hpp"
+
+namespace caf {
+namespace riac {
+
+/// Stores the state of all nodes for answering queries without scanning.
+/// Nodes are hashed by ID and indexed by hostname, actors are hashed by
+/// ID per node, routes are kept in sorted, contiguous vectors, and the
+/// hot actors of all nodes are indexed by their 99th percentile.
+class state_store {
+public:
+  /// Per-second rates of a route, computed from the last `traffic_delta`.
+  struct route_rates {
+    double messages;
+    double bytes;
+    double failures;
+  };
+
+  /// Stores everything known about a single node. The history of CPU load
+  /// and RAM usage takes 40 bytes per point, i.e., about 270 KB per node
+  /// with the default sizes.
+  struct node_state {
+    explicit node_state(size_t history_minutes = 1440,
+                        size_t history_hours = 720);
+
+    node_info node;
+    optional<ram_usage> ram;
+    optional<work_load> load;
+    std::vector<node_id> routes; // sorted
+    std::vector<std::pair<strong_actor_ptr, uint16_t>> published_actors;
+    std::unordered_map<actor_id, strong_actor_ptr> actors;
+    std::map<node_id, node_traffic> node_traffic_out;
+    actor_traffic_map actor_traffic_out;
+    forwarding_map forwarded;
+    route_events_map route_event_counts;
+    std::map<std::pair<node_id, node_id>, route_rates> rates;
+    uint64_t last_traffic = 0; // timestamp of the last traffic_delta
+    std::map<node_id, route_stats> latencies; // by peer
+    std::vector<actor_latency> hot_actors;
+    optional<thread_load> threads;
+    time_series cpu_load; // history of work_load::cpu_load
+    time_series ram_in_use; // history of ram_usage::in_use
+  };
+
+  using node_map = std::unordered_map<node_id, node_state>;
+
+  /// Creates a store keeping the given number of one-minute and one-hour
+  /// rollups of CPU load and RAM usage per node.
+  explicit state_store(size_t history_minutes = 1440,
+                       size_t history_hours = 720);
+
+  // -- modifiers --------------------------------------------------------------
+
+  void update(const node_info& x);
+
+  /// Stores `x` and records it in the history at `timestamp`.
+  void update(const ram_usage& x, uint64_t timestamp = now());
+
+  /// Stores `x` and records it in the history at `timestamp`.
+  void update(const work_load& x, uint64_t timestamp = now());
+
+  void update(const new_route& x);
+
+  void update(const route_lost& x);
+
+  void update(const route_stats& x);
+
+  void update(const actor_hotspots& x);
+
+  void update(const thread_load& x);
+
+  void update(const new_actor_published& x);
+
+  /// Accumulates `x` and computes route rates relative to the previous
+  /// `traffic_delta` of the same node.
+  void update(const traffic_delta& x, uint64_t timestamp = now());
+
+  void update(const event_batch& x);
+
+  /// Applies a chunk of a state transfer from the nexus.
+  void update(state_delta& x);
+
+  /// Replaces the entire state with `xs`.
+  void assign(probe_data_map& xs);
+
+  /// Removes `nid` and all of its indexes.
+  void erase(const node_id& nid);
+
+  void clear();
+
+  // -- queries ----------------------------------------------------------------
+
+  /// Returns the state of `nid` or `nullptr` if `nid` is unknown.
+  const node_state* find(const node_id& nid) const;
+
+  /// Returns all nodes running on `hostname`.
+  const std::vector<node_id>& nodes(const std::string& hostname) const;
+
+  /// Returns the actor `aid` on `nid` or `nullptr` if it is unknown.
+  strong_actor_ptr find_actor(const node_id& nid, actor_id aid) const;
+
+  /// Appends the `n` actors with the highest 99th percentile of their
+  /// mailbox sojourn time across all nodes to `out`.
+  void slowest(size_t n, std::vector<actor_latency>& out) const;
+
+  /// Appends the forwarding and failure statistics of all routes passing
+  /// through `via` to `out`.
+  void collect_routes(const node_id& via,
+                      std::vector<forwarding_stats>& out) const;
+
+  const node_map& nodes() const {
+    return nodes_;
+  }
+
+  size_t size() const {
+    return nodes_.size();
+  }
+
+  /// Returns the current time in milliseconds since epoch.
+  static uint64_t now();
+
+private:
+  // returns the state of `nid`, creating it if needed
+  node_state& get(const node_id& nid);
+
+  // updates the node info of `st` and the hostname index
+  void set_node(const node_id& nid, node_state& st, node_info x);
+
+  void assign(const node_id& nid, probe_data& x);
+
+  void unindex_hostname(const node_id& nid, const std::string& hostname);
+
+  // replaces the hot actors of `st` and updates the index
+  void set_hot_actors(const node_id& nid, node_state& st,
+                      std::vector<actor_latency> xs);
+
+  void unindex_hot_actors(const node_id& nid, const node_state& st);
+
+  // maps the 99th percentile of hot actors to their node and their
+  // position in `node_state::hot_actors`, slowest first
+  using slowest_index = std::multimap<uint64_t, std::pair<node_id, size_t>,
+                                      std::greater<uint64_t>>;
+
+  size_t history_minutes_;
+  size_t history_hours_;
+  node_map nodes_;
+  std::unordered_map<std::string, std::vector<node_id>> by_hostname_;
+  slowest_index slowest_;
+};
+
+} // namespace riac
+} // namespace caf
+
+#endif // CAF_RIAC_STATE_STORE_HPP
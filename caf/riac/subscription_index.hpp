@@ -0,0 +1,238 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2015                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#ifndef CAF_RIAC_SUBSCRIPTION_INDEX_HPP
+#define CAF_RIAC_SUBSCRIPTION_INDEX_HPP
+
+#include <map>
+#include <array>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <algorithm>
+#include <unordered_map>
+#include <initializer_list>
+
+#include "caf/riac/message_types.hpp"
+
+namespace caf {
+namespace riac {
+
+/// Returns whether `str` matches `pattern`, whereas `*` matches any
+/// sequence of characters and `?` matches any single character.
+inline bool glob_match(const std::string& pattern, const std::string& str) {
+  size_t p = 0;
+  size_t s = 0;
+  // position of the last `*` in the pattern and the matching position in str
+  auto star = std::string::npos;
+  size_t mark = 0;
+  while (s < str.size()) {
+    if (p < pattern.size() && (pattern[p] == '?' || pattern[p] == str[s])) {
+      ++p;
+      ++s;
+    } else if (p < pattern.size() && pattern[p] == '*') {
+      star = p++;
+      mark = s;
+    } else if (star != std::string::npos) {
+      p = star + 1;
+      s = ++mark;
+    } else {
+      return false;
+    }
+  }
+  while (p < pattern.size() && pattern[p] == '*')
+    ++p;
+  return p == pattern.size();
+}
+
+/// Maps events to the subscribers selecting them. Subscribers without node
+/// filter are indexed by event type, all others by node. Hence, dispatching
+/// an event only visits subscribers that are potentially interested in it.
+template <class Handle>
+class subscription_index {
+public:
+  /// Adds `hdl` with filter `sub`, returns `false` if `hdl` already exists.
+  bool add(Handle hdl, subscription sub) {
+    if (sub.events == 0)
+      sub.events = all_events;
+    auto res = entries_.emplace(hdl, entry{hdl, std::move(sub)});
+    if (! res.second)
+      return false;
+    auto& e = res.first->second;
+    if (! filters_nodes(e)) {
+      for (size_t i = 0; i < num_event_types; ++i)
+        if (e.sub.events & (1u << i))
+          by_type_[i].push_back(&e);
+      return true;
+    }
+    for (auto& nid : e.sub.nodes)
+      link(nid, &e);
+    if (! e.sub.hostname_pattern.empty())
+      for (auto& kvp : hostnames_)
+        if (glob_match(e.sub.hostname_pattern, kvp.second))
+          link(kvp.first, &e);
+    return true;
+  }
+
+  /// Removes `hdl`, returns `false` if `hdl` did not exist.
+  bool erase(const Handle& hdl) {
+    auto i = entries_.find(hdl);
+    if (i == entries_.end())
+      return false;
+    auto ptr = &i->second;
+    for (auto& xs : by_type_)
+      drop(xs, ptr);
+    for (auto j = by_node_.begin(); j != by_node_.end();) {
+      drop(j->second, ptr);
+      if (j->second.empty())
+        j = by_node_.erase(j);
+      else
+        ++j;
+    }
+    entries_.erase(i);
+    return true;
+  }
+
+  /// Stores the hostname of `nid` and selects `nid` for all subscribers
+  /// with a matching hostname pattern.
+  void add_node(const node_id& nid, const std::string& hostname) {
+    auto& hn = hostnames_[nid];
+    if (hn == hostname)
+      return;
+    if (! hn.empty())
+      remove_node(nid);
+    hostnames_[nid] = hostname;
+    for (auto& kvp : entries_) {
+      auto& e = kvp.second;
+      if (! e.sub.hostname_pattern.empty()
+          && glob_match(e.sub.hostname_pattern, hostname))
+        link(nid, &e);
+    }
+  }
+
+  /// Drops the hostname of `nid` along with all matches depending on it.
+  void remove_node(const node_id& nid) {
+    hostnames_.erase(nid);
+    auto i = by_node_.find(nid);
+    if (i == by_node_.end())
+      return;
+    auto& xs = i->second;
+    xs.erase(std::remove_if(xs.begin(), xs.end(),
+                            [&](entry* e) {
+                              return e->sub.nodes.count(nid) == 0;
+                            }),
+             xs.end());
+    if (xs.empty())
+      by_node_.erase(i);
+  }
+
+  /// Returns whether `hdl` selects events from `nid`.
+  bool selects(const Handle& hdl, const node_id& nid) const {
+    auto i = entries_.find(hdl);
+    if (i == entries_.end())
+      return false;
+    if (! filters_nodes(i->second))
+      return true;
+    auto j = by_node_.find(nid);
+    return j != by_node_.end()
+           && std::find(j->second.begin(), j->second.end(), &i->second)
+              != j->second.end();
+  }
+
+  /// Calls `f` for each subscriber selecting an event of type `flag` from
+  /// `nid`. Events concerning actors pass their IDs in `aids`.
+  template <class F>
+  void visit(uint32_t flag, const node_id& nid,
+             std::initializer_list<actor_id> aids, F f) const {
+    size_t pos = 0;
+    while (pos < num_event_types && flag != (1u << pos))
+      ++pos;
+    if (pos == num_event_types)
+      return;
+    for (auto e : by_type_[pos])
+      if (selects_actors(*e, aids))
+        f(e->hdl);
+    auto i = by_node_.find(nid);
+    if (i != by_node_.end())
+      for (auto e : i->second)
+        if ((e->sub.events & flag) != 0 && selects_actors(*e, aids))
+          f(e->hdl);
+  }
+
+  /// Calls `f` for each subscriber.
+  template <class F>
+  void for_each(F f) const {
+    for (auto& kvp : entries_)
+      f(kvp.first);
+  }
+
+  size_t size() const {
+    return entries_.size();
+  }
+
+  bool empty() const {
+    return entries_.empty();
+  }
+
+private:
+  static constexpr size_t num_event_types = 12;
+
+  static_assert(all_events == (1u << num_event_types) - 1,
+                "num_event_types does not match event_flags");
+
+  struct entry {
+    Handle hdl;
+    subscription sub;
+  };
+
+  static bool filters_nodes(const entry& e) {
+    return ! e.sub.nodes.empty() || ! e.sub.hostname_pattern.empty();
+  }
+
+  static bool selects_actors(const entry& e,
+                             std::initializer_list<actor_id> aids) {
+    if (e.sub.actors.empty() || aids.size() == 0)
+      return true;
+    for (auto aid : aids)
+      if (e.sub.actors.count(aid) > 0)
+        return true;
+    return false;
+  }
+
+  static void drop(std::vector<entry*>& xs, entry* x) {
+    xs.erase(std::remove(xs.begin(), xs.end(), x), xs.end());
+  }
+
+  void link(const node_id& nid, entry* e) {
+    auto& xs = by_node_[nid];
+    if (std::find(xs.begin(), xs.end(), e) == xs.end())
+      xs.push_back(e);
+  }
+
+  // entries never move, because `std::map` has stable references
+  std::map<Handle, entry> entries_;
+  std::array<std::vector<entry*>, num_event_types> by_type_;
+  std::unordered_map<node_id, std::vector<entry*>> by_node_;
+  std::map<node_id, std::string> hostnames_;
+};
+
+} // namespace riac
+} // namespace caf
+
+#endif // CAF_RIAC_SUBSCRIPTION_INDEX_HPP
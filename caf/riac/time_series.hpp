@@ -0,0 +1,101 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2015                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#ifndef CAF_RIAC_TIME_SERIES_HPP
+#define CAF_RIAC_TIME_SERIES_HPP
+
+#include <vector>
+#include <cstdint>
+
+#include "caf/riac/ring_buffer.hpp"
+#include "caf/riac/message_types.hpp"
+
+namespace caf {
+namespace riac {
+
+/// Keeps the history of a single metric in preallocated ring buffers with
+/// raw samples and rollups at 1s, 1min and 1h. Adding samples and range
+/// queries never allocate memory.
+class time_series {
+public:
+  enum resolution {
+    raw,
+    seconds,
+    minutes,
+    hours,
+    num_resolutions
+  };
+
+  /// Creates a series storing up to the given number of points per
+  /// resolution. The defaults keep 10 minutes of raw data (at one sample
+  /// per second), 10 minutes of seconds, one day of minutes and 30 days
+  /// of hours.
+  explicit time_series(size_t raw_size = 600, size_t seconds_size = 600,
+                       size_t minutes_size = 1440, size_t hours_size = 720);
+
+  /// Adds `value` sampled at `timestamp` (in milliseconds since epoch).
+  /// Timestamps must not decrease.
+  void add(uint64_t timestamp, double value);
+
+  /// Returns the finest resolution that still covers `from`.
+  resolution select(uint64_t from) const;
+
+  /// Calls `f` for each point in `[from, to]` at resolution `r` in
+  /// chronological order, including the incomplete rollup of the current
+  /// interval. Rollups overlapping `from` are included.
+  template <class F>
+  void range(resolution r, uint64_t from, uint64_t to, F f) const {
+    auto& xs = levels_[r];
+    auto w = width(r);
+    // find the first point ending after `from` via binary search
+    size_t first = 0;
+    size_t last = xs.size();
+    while (first < last) {
+      auto mid = first + (last - first) / 2;
+      if (xs[mid].timestamp + w > from)
+        last = mid;
+      else
+        first = mid + 1;
+    }
+    for (auto i = first; i < xs.size() && xs[i].timestamp <= to; ++i)
+      f(xs[i]);
+    if (r != raw) {
+      auto& x = open_[r];
+      if (x.count > 0 && x.timestamp + w > from && x.timestamp <= to)
+        f(x);
+    }
+  }
+
+  /// Appends all points in `[from, to]` at the finest resolution covering
+  /// `from` to `out`.
+  void range(uint64_t from, uint64_t to, std::vector<metric_point>& out) const;
+
+  /// Returns the interval length of resolution `r` in milliseconds.
+  static uint64_t width(resolution r);
+
+private:
+  ring_buffer<metric_point> levels_[num_resolutions];
+  // rollups of the current intervals, unused for raw samples
+  metric_point open_[num_resolutions];
+};
+
+} // namespace riac
+} // namespace caf
+
+#endif // CAF_RIAC_TIME_SERIES_HPP
@@ -0,0 +1,48 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2015                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#ifndef CAF_RIAC_TOPOLOGY_HPP
+#define CAF_RIAC_TOPOLOGY_HPP
+
+#include <string>
+#include <vector>
+#include <cstdint>
+
+#include "caf/riac/message_types.hpp"
+
+namespace caf {
+namespace riac {
+
+/// Returns one `cpu_info` per NUMA node of this machine. Reads the
+/// topology from `/sys/devices/system` and `/proc/cpuinfo` on Linux
+/// and falls back to a single entry without cache and NUMA information
+/// on other platforms.
+std::vector<cpu_info> cpu_topology(const node_id& source_node);
+
+/// Returns name, release and hardware identifier of the operating system.
+std::string os_version();
+
+/// Parses a list of CPUs or NUMA nodes in the format used by
+/// the Linux kernel, e.g., `0-3,8-11`.
+std::vector<uint32_t> parse_cpu_list(const std::string& str);
+
+} // namespace riac
+} // namespace caf
+
+#endif // CAF_RIAC_TOPOLOGY_HPP
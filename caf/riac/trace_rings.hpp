@@ -0,0 +1,66 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2015                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#ifndef CAF_RIAC_TRACE_RINGS_HPP
+#define CAF_RIAC_TRACE_RINGS_HPP
+
+#include <mutex>
+#include <atomic>
+#include <memory>
+#include <vector>
+#include <cstdint>
+
+#include "caf/riac/spsc_ring.hpp"
+#include "caf/riac/message_types.hpp"
+
+namespace caf {
+namespace riac {
+
+/// Collects message traces in one `spsc_ring` per producing thread. Pushing
+/// a trace only acquires a lock the first time a thread pushes to this
+/// instance, afterwards it is wait-free. Full rings drop new traces.
+class trace_rings {
+public:
+  explicit trace_rings(size_t ring_size);
+
+  /// Stores `x` in the ring of the calling thread.
+  bool push(new_message&& x);
+
+  /// Moves all stored traces to `out` and returns the number of traces
+  /// dropped since the last call.
+  uint64_t drain(std::vector<new_message>& out);
+
+private:
+  using ring = spsc_ring<new_message>;
+
+  // returns the ring of the calling thread, creating it if needed
+  ring& local();
+
+  // distinguishes instances in the thread-local lookup
+  uint64_t id_;
+  size_t ring_size_;
+  std::mutex mtx_;
+  std::vector<std::unique_ptr<ring>> rings_;
+  std::atomic<uint64_t> dropped_;
+};
+
+} // namespace riac
+} // namespace caf
+
+#endif // CAF_RIAC_TRACE_RINGS_HPP
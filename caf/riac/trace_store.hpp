@@ -0,0 +1,98 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2015                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#ifndef CAF_RIAC_TRACE_STORE_HPP
+#define CAF_RIAC_TRACE_STORE_HPP
+
+#include <map>
+#include <deque>
+#include <vector>
+#include <cstdint>
+#include <utility>
+#include <unordered_map>
+
+#include "caf/node_id.hpp"
+
+#include "caf/riac/message_types.hpp"
+
+namespace caf {
+namespace riac {
+
+/// Assembles traced requests and responses into spans and links them to
+/// trees in a bounded store. A span is identified by the requesting actor
+/// and the request ID, which both ends of a message observe alike. A
+/// request sent by an actor while it is serving another request becomes
+/// a child span of the latter. Asynchronous messages carry no request ID
+/// and are ignored. Once the store is full, the oldest span gets dropped.
+class trace_store {
+public:
+  /// Masks for `new_message::mid`, matching the layout of `message_id`.
+  static constexpr uint64_t response_flag_mask = 0x8000000000000000;
+
+  static constexpr uint64_t request_id_mask = 0x1FFFFFFFFFFFFFFF;
+
+  explicit trace_store(size_t max_spans = 10000);
+
+  /// Adds a traced message to its span.
+  void add(const new_message& x);
+
+  /// Appends all spans of trace `id` to `out`, ordered by their start.
+  void trace(uint64_t id, std::vector<span_info>& out) const;
+
+  /// Appends the `n` complete root spans with the highest latency as
+  /// seen by the client to `out`, slowest first.
+  void slowest(size_t n, std::vector<span_info>& out) const;
+
+  size_t size() const {
+    return spans_.size();
+  }
+
+  /// Returns the ID of the span for the request `request_id` of `client`.
+  static uint64_t span_id(const node_id& client_node, actor_id client,
+                          uint64_t request_id);
+
+private:
+  using actor_key = std::pair<node_id, actor_id>;
+
+  // returns the span `id`, creating it if needed
+  span_info& get(uint64_t id, const new_message& x, bool response);
+
+  // makes `x` a child of the latest request its client is serving
+  void link(span_info& x);
+
+  // moves all spans of trace `from` to trace `to`
+  void retrace(uint64_t from, uint64_t to);
+
+  void deactivate(const span_info& x);
+
+  void evict();
+
+  size_t max_spans_;
+  std::unordered_map<uint64_t, span_info> spans_;
+  // span IDs in order of creation
+  std::deque<uint64_t> order_;
+  std::unordered_multimap<uint64_t, uint64_t> by_trace_;
+  // requests an actor received but did not answer yet
+  std::map<actor_key, std::vector<uint64_t>> active_;
+};
+
+} // namespace riac
+} // namespace caf
+
+#endif // CAF_RIAC_TRACE_STORE_HPP
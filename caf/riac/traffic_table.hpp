@@ -0,0 +1,169 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2015                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#ifndef CAF_RIAC_TRAFFIC_TABLE_HPP
+#define CAF_RIAC_TRAFFIC_TABLE_HPP
+
+#include <memory>
+#include <atomic>
+#include <thread>
+#include <cstdint>
+#include <cstddef>
+#include <functional>
+
+namespace caf {
+namespace riac {
+
+/// A fixed-size hash table for counting messages and bytes per key. Adding
+/// to an existing entry as well as inserting new entries never blocks,
+/// i.e., the table is safe to use from the I/O loop of the middleman.
+/// The table consists of two generations. Writers count in the current
+/// one, while `collect` switches to the other generation and empties the
+/// previous one. Hence, keys without messages during an interval do not
+/// occupy a slot afterwards. Messages with new keys that find no free slot
+/// within a few probes are only counted as dropped.
+template <class Key, class Hash = std::hash<Key>>
+class traffic_table {
+public:
+  /// Maximum number of slots visited for finding a key.
+  static constexpr size_t max_probes = 64;
+
+  explicit traffic_table(size_t capacity)
+      : capacity_(capacity > 0 ? capacity : 1),
+        current_(0),
+        dropped_(0) {
+    for (auto& gen : gens_) {
+      gen.slots.reset(new slot[capacity_]);
+      gen.writers = 0;
+    }
+  }
+
+  traffic_table(const traffic_table&) = delete;
+  traffic_table& operator=(const traffic_table&) = delete;
+
+  /// Counts one message of size `bytes` for `key`.
+  bool add(const Key& key, uint64_t bytes) {
+    // pins the current generation, `collect` waits for all pinned writers
+    auto& gen = pin();
+    auto result = add(gen, key, bytes);
+    gen.writers.fetch_sub(1);
+    if (! result)
+      dropped_.fetch_add(1, std::memory_order_relaxed);
+    return result;
+  }
+
+  /// Calls `f(key, messages, bytes)` for each entry with a non-zero
+  /// message count since the last call, empties the table and returns
+  /// how many messages were dropped in the meantime. Only one thread at a
+  /// time may call this function.
+  template <class F>
+  size_t collect(F f) {
+    auto& gen = gens_[current_.load()];
+    current_.store(current_.load() == 0 ? 1 : 0);
+    while (gen.writers.load() > 0)
+      std::this_thread::yield();
+    for (size_t i = 0; i < capacity_; ++i) {
+      auto& x = gen.slots[i];
+      if (x.state.load(std::memory_order_acquire) != ready)
+        continue;
+      auto messages = x.messages.load(std::memory_order_relaxed);
+      if (messages > 0)
+        f(x.key, messages, x.bytes.load(std::memory_order_relaxed));
+      x.key = Key{};
+      x.messages.store(0, std::memory_order_relaxed);
+      x.bytes.store(0, std::memory_order_relaxed);
+      x.state.store(empty, std::memory_order_release);
+    }
+    return dropped_.exchange(0, std::memory_order_relaxed);
+  }
+
+private:
+  enum : int {
+    empty,
+    busy,
+    ready
+  };
+
+  struct slot {
+    slot() : state(empty), messages(0), bytes(0) {
+      // nop
+    }
+    std::atomic<int> state;
+    Key key;
+    std::atomic<uint64_t> messages;
+    std::atomic<uint64_t> bytes;
+  };
+
+  struct generation {
+    std::unique_ptr<slot[]> slots;
+    std::atomic<size_t> writers;
+  };
+
+  generation& pin() {
+    for (;;) {
+      auto i = current_.load();
+      auto& gen = gens_[i];
+      gen.writers.fetch_add(1);
+      // `collect` may have switched generations in the meantime
+      if (current_.load() == i)
+        return gen;
+      gen.writers.fetch_sub(1);
+    }
+  }
+
+  bool add(generation& gen, const Key& key, uint64_t bytes) {
+    auto first = Hash{}(key) % capacity_;
+    auto probes = capacity_ < max_probes ? capacity_ : max_probes;
+    for (size_t n = 0; n < probes; ++n) {
+      auto& x = gen.slots[(first + n) % capacity_];
+      auto st = x.state.load(std::memory_order_acquire);
+      if (st == empty) {
+        if (x.state.compare_exchange_strong(st, busy,
+                                            std::memory_order_acq_rel)) {
+          x.key = key;
+          x.state.store(ready, std::memory_order_release);
+          x.messages.fetch_add(1, std::memory_order_relaxed);
+          x.bytes.fetch_add(bytes, std::memory_order_relaxed);
+          return true;
+        }
+      }
+      // another thread may currently initialize this slot
+      while (st == busy) {
+        std::this_thread::yield();
+        st = x.state.load(std::memory_order_acquire);
+      }
+      if (x.key == key) {
+        x.messages.fetch_add(1, std::memory_order_relaxed);
+        x.bytes.fetch_add(bytes, std::memory_order_relaxed);
+        return true;
+      }
+    }
+    return false;
+  }
+
+  size_t capacity_;
+  generation gens_[2];
+  std::atomic<size_t> current_;
+  std::atomic<size_t> dropped_;
+};
+
+} // namespace riac
+} // namespace caf
+
+#endif // CAF_RIAC_TRAFFIC_TABLE_HPP
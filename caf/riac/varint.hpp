@@ -0,0 +1,68 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2015                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#ifndef CAF_RIAC_VARINT_HPP
+#define CAF_RIAC_VARINT_HPP
+
+#include <vector>
+#include <cstdint>
+
+// Integer encodings shared by the compact wire format and the export
+// format. Not part of the public API, hence not included by `all.hpp`.
+
+namespace caf {
+namespace riac {
+
+/// Maps signed integers to unsigned ones with small absolute values
+/// resulting in small numbers, e.g., for encoding deltas as varints.
+inline uint64_t zigzag(int64_t x) {
+  return (static_cast<uint64_t>(x) << 1) ^ static_cast<uint64_t>(x >> 63);
+}
+
+/// Reverts `zigzag`.
+inline int64_t unzigzag(uint64_t x) {
+  return static_cast<int64_t>(x >> 1) ^ -static_cast<int64_t>(x & 1);
+}
+
+/// Appends `x` to `buf` using 7 bits per byte, least significant first.
+inline void write_varint(std::vector<char>& buf, uint64_t x) {
+  while (x >= 0x80) {
+    buf.push_back(static_cast<char>((x & 0x7F) | 0x80));
+    x >>= 7;
+  }
+  buf.push_back(static_cast<char>(x));
+}
+
+/// Reads a varint from `[pos, last)` into `x` and advances `pos`. Returns
+/// `false` if the input ends early or the varint exceeds 64 bits.
+inline bool read_varint(const char*& pos, const char* last, uint64_t& x) {
+  x = 0;
+  for (int shift = 0; pos != last && shift < 64; shift += 7) {
+    auto byte = static_cast<uint8_t>(*pos++);
+    x |= static_cast<uint64_t>(byte & 0x7F) << shift;
+    if ((byte & 0x80) == 0)
+      return true;
+  }
+  return false;
+}
+
+} // namespace riac
+} // namespace caf
+
+#endif // CAF_RIAC_VARINT_HPP
@@ -0,0 +1,81 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2015                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#ifndef CAF_RIAC_WIRE_FORMAT_HPP
+#define CAF_RIAC_WIRE_FORMAT_HPP
+
+#include <vector>
+#include <cstdint>
+#include <unordered_map>
+
+#include "caf/node_id.hpp"
+
+#include "caf/riac/message_types.hpp"
+
+namespace caf {
+namespace riac {
+
+/// Encodes events for the probe-to-nexus link. Each batch starts with a
+/// flags byte and the number of dropped events, followed by records that
+/// consist of a tag and a fixed sequence of fields. Integers are encoded
+/// as varints and timestamps as zigzag-encoded deltas to the previous
+/// record. Node IDs are sent in full only once per session and
+/// afterwards referred to by a small integer.
+class wire_encoder {
+public:
+  wire_encoder();
+
+  /// Starts a new session. The receiver drops its node IDs
+  /// when decoding the next batch.
+  void reset();
+
+  /// Moves all events with a compact representation from `x` into a
+  /// new `compact_batch`. Messages with content remain in `x`.
+  compact_batch encode(event_batch& x);
+
+private:
+  void write(uint64_t x);
+
+  void write(const node_id& x);
+
+  std::vector<char> buf_;
+  std::unordered_map<node_id, uint64_t> ids_;
+  bool reset_;
+};
+
+/// Decodes batches produced by a `wire_encoder` directly from their
+/// buffer. Each encoder requires its own decoder.
+class wire_decoder {
+public:
+  /// Appends all events in `x` to `out` and sets `out.dropped`.
+  /// Returns `false` if `x` is malformed.
+  bool decode(const compact_batch& x, event_batch& out);
+
+private:
+  bool read(const char*& pos, const char* last, uint64_t& x);
+
+  bool read(const char*& pos, const char* last, node_id& x);
+
+  std::vector<node_id> ids_;
+};
+
+} // namespace riac
+} // namespace caf
+
+#endif // CAF_RIAC_WIRE_FORMAT_HPP
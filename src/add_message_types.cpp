@@ -34,14 +34,42 @@ void add_message_types(actor_system_config& cfg) {
      .add_message_type<work_load>("@work_load")
      .add_message_type<new_route>("@new_route")
      .add_message_type<route_lost>("@route_lost")
+     .add_message_type<route_stats>("@route_stats")
+     .add_message_type<std::vector<route_stats>>("@route_stats_vec")
+     .add_message_type<span_info>("@span_info")
+     .add_message_type<std::vector<span_info>>("@span_info_vec")
+     .add_message_type<thread_stats>("@thread_stats")
+     .add_message_type<std::vector<thread_stats>>("@thread_stats_vec")
+     .add_message_type<thread_load>("@thread_load")
+     .add_message_type<optional<thread_load>>("@opt_thread_load")
+     .add_message_type<actor_latency>("@actor_latency")
+     .add_message_type<std::vector<actor_latency>>("@actor_latency_vec")
+     .add_message_type<actor_hotspots>("@actor_hotspots")
      .add_message_type<new_message>("@new_message")
      .add_message_type<optional<ram_usage>>("@opt_ram_usage")
      .add_message_type<optional<work_load>>("@opt_work_load")
      .add_message_type<std::set<node_id>>("@opt_node_id")
      .add_message_type<std::set<actor_addr>>("@actor_addr_set")
      .add_message_type<new_actor_published>("@new_actor_published")
+     .add_message_type<actor_traffic>("@actor_traffic")
+     .add_message_type<node_traffic>("@node_traffic")
+     .add_message_type<forwarding_traffic>("@forwarding_traffic")
+     .add_message_type<route_events>("@route_events")
+     .add_message_type<traffic_delta>("@traffic_delta")
+     .add_message_type<std::vector<actor_traffic>>("@actor_traffic_vec")
+     .add_message_type<std::vector<node_traffic>>("@node_traffic_vec")
+     .add_message_type<event_batch>("@event_batch")
+     .add_message_type<compact_batch>("@compact_batch")
+     .add_message_type<region_summary>("@region_summary")
+     .add_message_type<metric_point>("@metric_point")
+     .add_message_type<std::vector<metric_point>>("@metric_point_vec")
+     .add_message_type<forwarding_stats>("@forwarding_stats")
+     .add_message_type<std::vector<forwarding_stats>>("@forwarding_stats_vec")
      .add_message_type<probe_data>("@probe_data")
      .add_message_type<probe_data_map>("@probe_data_map")
+     .add_message_type<state_delta>("@state_delta")
+     .add_message_type<std::set<actor_id>>("@actor_id_set")
+     .add_message_type<subscription>("@subscription")
      .add_message_type<sink_type>("@sink_type")
      .add_message_type<nexus_type>("@nexus_type");
 }
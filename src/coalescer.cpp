@@ -0,0 +1,52 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2015                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#include "caf/riac/coalescer.hpp"
+
+namespace caf {
+namespace riac {
+
+void coalescer::add(const ram_usage& x) {
+  batch(x.source_node).ram.assign(1, x);
+}
+
+void coalescer::add(const work_load& x) {
+  batch(x.source_node).load.assign(1, x);
+}
+
+void coalescer::add(const thread_load& x) {
+  batch(x.source_node).threads.assign(1, x);
+}
+
+void coalescer::erase(const node_id& nid) {
+  pending_.erase(nid);
+}
+
+event_batch& coalescer::batch(const node_id& nid) {
+  auto i = pending_.find(nid);
+  if (i != pending_.end())
+    return i->second;
+  auto& result = pending_[nid];
+  result.source_node = nid;
+  result.dropped = 0;
+  return result;
+}
+
+} // namespace riac
+} // namespace caf
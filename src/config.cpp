@@ -0,0 +1,169 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2015                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#include "caf/riac/config.hpp"
+
+namespace caf {
+namespace riac {
+
+settings::settings()
+    : batch_size(128),
+      flush_interval(100),
+      max_pending(10000),
+      connect_timeout(5000),
+      reconnect_delay(500),
+      max_reconnect_delay(30000),
+      compact_wire(true),
+      trace_messages(true),
+      measure_sizes(true),
+      ring_size(4096),
+      sample_rate(1),
+      max_rate(0),
+      capture_rate(1),
+      span_rate(100),
+      trace_store_size(10000),
+      history_minutes(1440),
+      history_hours(720),
+      traffic_interval(1000),
+      traffic_table_size(4096),
+      stats_interval(1000),
+      thread_stats_interval(5000),
+      ping_interval(1000),
+      ping_payload(0),
+      ping_report_interval(10000),
+      profile_interval(1000),
+      hot_actors(10),
+      profile_report_interval(10000),
+      snapshot_chunk_size(64),
+      coalesce_interval(0),
+      listener_queue(1000),
+      region_interval(1000),
+      region_max_messages(1000),
+      snapshot_interval(10000),
+      snapshot_grace(60000),
+      metrics_port(0),
+      export_file_size(64 * 1024 * 1024),
+      export_max_files(0),
+      export_block_rows(4096),
+      export_interval(1000) {
+  // nop
+}
+
+config::config() {
+  opt_group{custom_options_, "riac"}
+  .add(riac.batch_size, "batch-size",
+       "sets the maximum number of events per batch sent to the nexus")
+  .add(riac.flush_interval, "flush-interval",
+       "sets the interval for sending pending events to the nexus (in ms)")
+  .add(riac.max_pending, "max-pending",
+       "sets the maximum number of buffered events while disconnected")
+  .add(riac.connect_timeout, "connect-timeout",
+       "sets the timeout for connecting to the nexus (in ms)")
+  .add(riac.reconnect_delay, "reconnect-delay",
+       "sets the initial delay for reconnecting to the nexus (in ms)")
+  .add(riac.max_reconnect_delay, "max-reconnect-delay",
+       "sets the maximum delay for reconnecting to the nexus (in ms)")
+  .add(riac.compact_wire, "compact-wire",
+       "enables or disables the compact wire format for events")
+  .add(riac.trace_messages, "trace-messages",
+       "enables or disables tracing of individual messages")
+  .add(riac.measure_sizes, "measure-sizes",
+       "enables or disables counting the bytes of sent messages")
+  .add(riac.ring_size, "ring-size",
+       "sets the number of buffered message traces per thread")
+  .add(riac.sample_rate, "sample-rate",
+       "sets the ratio of messages reported to the nexus to 1/N")
+  .add(riac.max_rate, "max-rate",
+       "sets the maximum of messages reported per second (0 = unlimited)")
+  .add(riac.sample_rates, "sample-rates",
+       "sets per-actor sample rates in the format 'id=rate,...'")
+  .add(riac.capture_actors, "capture-actors",
+       "sets a comma-separated list of actor IDs for capturing payloads")
+  .add(riac.capture_types, "capture-types",
+       "sets a comma-separated list of type names for capturing payloads")
+  .add(riac.capture_rate, "capture-rate",
+       "sets the ratio of matching messages with captured payload to 1/N")
+  .add(riac.span_rate, "span-rate",
+       "sets the ratio of requests traced on all nodes to 1/N (0 = off)")
+  .add(riac.trace_store_size, "trace-store-size",
+       "sets the maximum number of spans kept by a nexus proxy")
+  .add(riac.history_minutes, "history-minutes",
+       "sets the number of one-minute rollups kept per node")
+  .add(riac.history_hours, "history-hours",
+       "sets the number of one-hour rollups kept per node")
+  .add(riac.traffic_interval, "traffic-interval",
+       "sets the interval for reporting traffic counters (in ms, 0 = off)")
+  .add(riac.traffic_table_size, "traffic-table-size",
+       "sets the maximum number of actor and node pairs for counting")
+  .add(riac.stats_interval, "stats-interval",
+       "sets the interval for reporting RAM usage and load (in ms, 0 = off)")
+  .add(riac.thread_stats_interval, "thread-stats-interval",
+       "sets the interval for reporting CPU usage per thread (in ms, 0 = off)")
+  .add(riac.ping_interval, "ping-interval",
+       "sets the interval for pinging connected nodes (in ms, 0 = off)")
+  .add(riac.ping_payload, "ping-payload",
+       "sets the payload size for estimating bandwidth (in bytes, 0 = off)")
+  .add(riac.ping_report_interval, "ping-report-interval",
+       "sets the interval for reporting latency percentiles (in ms)")
+  .add(riac.profile_interval, "profile-interval",
+       "sets the interval for measuring actor sojourn times (in ms, 0 = off)")
+  .add(riac.profile_actors, "profile-actors",
+       "sets a comma-separated list of actor IDs for profiling")
+  .add(riac.hot_actors, "hot-actors",
+       "sets the number of hottest actors reported per node")
+  .add(riac.profile_report_interval, "profile-report-interval",
+       "sets the interval for reporting the hottest actors (in ms)")
+  .add(riac.region_interval, "region-interval",
+       "sets the interval for forwarding events from a regional nexus (in ms)")
+  .add(riac.region_max_messages, "region-max-messages",
+       "sets the maximum number of traces forwarded per region interval")
+  .add(riac.snapshot_chunk_size, "snapshot-chunk-size",
+       "sets the maximum number of nodes per state transfer message")
+  .add(riac.coalesce_interval, "coalesce-interval",
+       "sets the interval for broadcasting load updates (in ms, 0 = off)")
+  .add(riac.listener_queue, "listener-queue",
+       "sets the maximum number of queued events per listener without credit")
+  .add(riac.snapshot_path, "snapshot-path",
+       "sets a file for persisting the state of the nexus across restarts")
+  .add(riac.snapshot_interval, "snapshot-interval",
+       "sets the interval for writing snapshots of the nexus (in ms)")
+  .add(riac.snapshot_grace, "snapshot-grace",
+       "sets the time until restored nodes must have reconnected (in ms)")
+  .add(riac.metrics_port, "metrics-port",
+       "sets the port for serving Prometheus metrics via HTTP (0 = off)")
+  .add(riac.export_file_size, "export-file-size",
+       "sets the size for starting a new export file (in bytes, 0 = off)")
+  .add(riac.export_max_files, "export-max-files",
+       "sets the number of kept export files (0 = unlimited)")
+  .add(riac.export_block_rows, "export-block-rows",
+       "sets the maximum number of rows per block in export files")
+  .add(riac.export_interval, "export-interval",
+       "sets the interval for writing pending rows to export files (in ms)");
+}
+
+const settings& get_settings(const actor_system_config& cfg) {
+  auto ptr = dynamic_cast<const config*>(&cfg);
+  if (ptr)
+    return ptr->riac;
+  static settings defaults;
+  return defaults;
+}
+
+} // namespace riac
+} // namespace caf
@@ -0,0 +1,160 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2015                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#include "caf/riac/event_buffer.hpp"
+
+#include <algorithm>
+
+#include "caf/message.hpp"
+#include "caf/message_id.hpp"
+#include "caf/actor_cast.hpp"
+
+namespace caf {
+namespace riac {
+
+event_buffer::event_buffer(node_id source_node, size_t max_size,
+                           size_t max_pending, bool compact)
+    : uplink_(unsafe_actor_handle_init),
+      uplink_ptr_(nullptr),
+      max_size_(max_size > 0 ? max_size : 1),
+      max_pending_(std::max(max_pending, max_size_)),
+      size_(0),
+      dropped_(0),
+      total_dropped_(0),
+      compact_(compact) {
+  batch_.source_node = std::move(source_node);
+  batch_.dropped = 0;
+}
+
+void event_buffer::connect(nexus_type uplink, strong_actor_ptr sender) {
+  std::unique_lock<std::mutex> guard{mtx_};
+  uplink_ = std::move(uplink);
+  uplink_ptr_ = actor_cast<actor_control_block*>(uplink_);
+  sender_ = std::move(sender);
+  // node IDs sent in a previous session are unknown to the new uplink
+  encoder_.reset();
+  flush_impl();
+}
+
+void event_buffer::disconnect() {
+  std::unique_lock<std::mutex> guard{mtx_};
+  uplink_ = nexus_type{unsafe_actor_handle_init};
+  uplink_ptr_ = nullptr;
+  sender_ = nullptr;
+}
+
+bool event_buffer::connected() {
+  std::unique_lock<std::mutex> guard{mtx_};
+  return ! uplink_.unsafe();
+}
+
+bool event_buffer::is_uplink(const strong_actor_ptr& x) const {
+  return x && x.get() == uplink_ptr_.load();
+}
+
+uint64_t event_buffer::dropped() {
+  std::unique_lock<std::mutex> guard{mtx_};
+  return total_dropped_;
+}
+
+void event_buffer::push(ram_usage x) {
+  push_impl(batch_.ram, x);
+}
+
+void event_buffer::push(work_load x) {
+  push_impl(batch_.load, x);
+}
+
+void event_buffer::push(new_route x) {
+  push_impl(batch_.routes, x);
+}
+
+void event_buffer::push(new_message x) {
+  push_impl(batch_.messages, x);
+}
+
+void event_buffer::push(new_actor_published x) {
+  push_impl(batch_.published_actors, x);
+}
+
+void event_buffer::push(traffic_delta x) {
+  push_impl(batch_.traffic, x);
+}
+
+void event_buffer::push(route_stats x) {
+  push_impl(batch_.latencies, x);
+}
+
+void event_buffer::push(actor_hotspots x) {
+  push_impl(batch_.hotspots, x);
+}
+
+void event_buffer::push(thread_load x) {
+  push_impl(batch_.threads, x);
+}
+
+void event_buffer::push(std::vector<new_message>& xs, uint64_t dropped) {
+  std::unique_lock<std::mutex> guard{mtx_};
+  dropped_ += dropped;
+  total_dropped_ += dropped;
+  for (auto& x : xs) {
+    if (size_ >= max_pending_) {
+      ++dropped_;
+      ++total_dropped_;
+      continue;
+    }
+    batch_.messages.emplace_back(std::move(x));
+    if (++size_ >= max_size_ && ! uplink_.unsafe())
+      flush_impl();
+  }
+  xs.clear();
+}
+
+void event_buffer::flush() {
+  std::unique_lock<std::mutex> guard{mtx_};
+  if (! uplink_.unsafe())
+    flush_impl();
+}
+
+void event_buffer::flush_impl() {
+  if (size_ == 0 && dropped_ == 0)
+    return;
+  event_batch tmp;
+  tmp.source_node = batch_.source_node;
+  tmp.dropped = 0;
+  std::swap(tmp, batch_);
+  tmp.dropped = dropped_;
+  size_ = 0;
+  dropped_ = 0;
+  // we are still holding the lock while enqueueing in order to guarantee
+  // that batches arrive in the same order they were created in
+  if (compact_) {
+    uplink_->enqueue(sender_, message_id::make(),
+                     make_message(encoder_.encode(tmp)), nullptr);
+    if (tmp.messages.empty() && tmp.published_actors.empty()
+        && tmp.latencies.empty() && tmp.hotspots.empty()
+        && tmp.threads.empty())
+      return;
+  }
+  uplink_->enqueue(sender_, message_id::make(),
+                   make_message(std::move(tmp)), nullptr);
+}
+
+} // namespace riac
+} // namespace caf
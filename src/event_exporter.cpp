@@ -0,0 +1,117 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2015                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#include "caf/riac/event_exporter.hpp"
+
+#include <chrono>
+#include <iostream>
+#include <algorithm>
+
+#include "caf/riac/config.hpp"
+
+namespace caf {
+namespace riac {
+
+namespace {
+
+uint64_t timestamp() {
+  using namespace std::chrono;
+  auto t = system_clock::now().time_since_epoch();
+  return static_cast<uint64_t>(duration_cast<microseconds>(t).count());
+}
+
+} // namespace <anonymous>
+
+const char* event_exporter_state::name = "riac_event_exporter";
+
+event_exporter_type::behavior_type
+event_exporter(event_exporter_type::stateful_pointer<event_exporter_state>
+                 self,
+               std::string path) {
+  auto& st = get_settings(self->home_system().config());
+  self->state.writer.reset(new export_writer(std::move(path),
+                                             st.export_file_size,
+                                             st.export_max_files,
+                                             st.export_block_rows));
+  auto interval = std::chrono::milliseconds(std::max<size_t>(
+                                              1, st.export_interval));
+  self->delayed_send(self, interval, tick_atom::value);
+  // events without timestamp get the time of their arrival
+  return {
+    // from sink_type
+    [=](const node_info&) {
+      // nop
+    },
+    [=](const ram_usage& ru) {
+      self->state.writer->add(timestamp(), ru);
+    },
+    [=](const work_load& wl) {
+      self->state.writer->add(timestamp(), wl);
+    },
+    [=](const new_route& route) {
+      self->state.writer->add(timestamp(), route);
+    },
+    [=](const route_lost& route) {
+      self->state.writer->add(timestamp(), route);
+    },
+    [=](const new_message& msg) {
+      self->state.writer->add(msg);
+    },
+    [=](const new_actor_published&) {
+      // nop
+    },
+    [=](const traffic_delta& td) {
+      self->state.writer->add(timestamp(), td);
+    },
+    [=](const route_stats&) {
+      // nop
+    },
+    [=](const actor_hotspots&) {
+      // nop
+    },
+    [=](const thread_load&) {
+      // nop
+    },
+    [=](const node_disconnected&) {
+      // nop
+    },
+    // from listener_type, coalesced updates of a single node
+    [=](const event_batch& x) {
+      auto t = timestamp();
+      for (auto& y : x.ram)
+        self->state.writer->add(t, y);
+      for (auto& y : x.load)
+        self->state.writer->add(t, y);
+    },
+    // from listener_type, the exporter keeps no state
+    [=](const state_delta&) {
+      // nop
+    },
+    // from event_exporter_type
+    [=](tick_atom) {
+      if (! self->state.writer->flush())
+        std::cerr << "unable to export events to "
+                  << self->state.writer->current_file() << std::endl;
+      self->delayed_send(self, interval, tick_atom::value);
+    }
+  };
+}
+
+} // namespace riac
+} // namespace caf
@@ -0,0 +1,562 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2015                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#include "caf/riac/export_format.hpp"
+
+#include "caf/config.hpp"
+
+#ifndef CAF_WINDOWS
+#include <dirent.h>
+#include <sys/stat.h>
+#endif
+
+#include <tuple>
+#include <cstdio>
+#include <limits>
+#include <cstdlib>
+#include <cstring>
+#include <algorithm>
+
+#include "caf/riac/varint.hpp"
+
+namespace caf {
+namespace riac {
+
+namespace {
+
+constexpr char file_magic[] = "RIACEXP1";
+
+constexpr char index_magic[] = "RIACIDX1";
+
+constexpr size_t magic_size = 8;
+
+// offset of the index followed by `index_magic`
+constexpr size_t trailer_size = 8 + magic_size;
+
+constexpr size_t host_id_size = std::tuple_size<node_id::host_id_type>::value;
+
+// returns the columns after `time` and `node`, see `export_table`
+const std::vector<const char*>& schema(export_table x) {
+  static const std::vector<std::vector<const char*>> schemas = {
+    {},
+    {"dest_node", "source_actor", "dest_actor", "mid", "type_token", "size",
+     "received"},
+    {"source_actor", "dest_node", "dest_actor", "messages", "bytes"},
+    {"dest_node", "messages", "bytes"},
+    {"in_use", "available"},
+    {"cpu_load", "num_processes", "num_actors"},
+    {"dest", "state"}
+  };
+  return schemas[static_cast<size_t>(x)];
+}
+
+bool valid_table(uint8_t x) {
+  return x < export_tables;
+}
+
+// returns N for all existing files `path.N`
+std::vector<size_t> existing_files(const std::string& path) {
+  std::vector<size_t> result;
+# ifndef CAF_WINDOWS
+  auto sep = path.find_last_of('/');
+  auto dir = sep == std::string::npos ? std::string{"."}
+                                      : path.substr(0, sep + 1);
+  auto prefix = (sep == std::string::npos ? path : path.substr(sep + 1))
+                + ".";
+  auto dp = opendir(dir.c_str());
+  if (! dp)
+    return result;
+  while (auto entry = readdir(dp)) {
+    std::string name = entry->d_name;
+    if (name.size() <= prefix.size()
+        || name.compare(0, prefix.size(), prefix) != 0)
+      continue;
+    auto digits = name.substr(prefix.size());
+    if (digits.find_first_not_of("0123456789") == std::string::npos)
+      result.push_back(std::strtoull(digits.c_str(), nullptr, 10));
+  }
+  closedir(dp);
+# else
+  // without directory listing, stop at the first gap
+  for (size_t i = 0; std::ifstream{path + "." + std::to_string(i)}; ++i)
+    result.push_back(i);
+# endif
+  return result;
+}
+
+} // namespace <anonymous>
+
+size_t column_count(export_table x) {
+  auto i = static_cast<size_t>(x);
+  return i < export_tables && i > 0 ? schema(x).size() + 2 : 0;
+}
+
+const char* column_name(export_table x, size_t i) {
+  if (i >= column_count(x))
+    return nullptr;
+  if (i < 2)
+    return i == 0 ? "time" : "node";
+  return schema(x)[i - 2];
+}
+
+export_writer::export_writer(std::string path, size_t max_file_size,
+                             size_t max_files, size_t block_rows)
+    : path_(std::move(path)),
+      max_file_size_(max_file_size),
+      max_files_(max_files),
+      block_rows_(std::max<size_t>(1, block_rows)),
+      seq_(0),
+      offset_(0) {
+  for (size_t i = 1; i < export_tables; ++i)
+    tables_[i].resize(column_count(static_cast<export_table>(i)));
+  if (max_file_size_ == 0)
+    return;
+  // continue after the files of a previous run instead of overwriting them
+  auto seqs = existing_files(path_);
+  if (seqs.empty())
+    return;
+  seq_ = *std::max_element(seqs.begin(), seqs.end()) + 1;
+  // drop files beyond `max_files`, e.g., from a run with a larger limit
+  if (max_files_ > 0)
+    for (auto n : seqs)
+      if (n + max_files_ <= seq_) {
+        auto expired = path_ + "." + std::to_string(n);
+        std::remove(expired.c_str());
+      }
+}
+
+export_writer::~export_writer() {
+  close();
+}
+
+void export_writer::add(const new_message& x) {
+  append(export_table::messages,
+         {x.timestamp, ref(x.source_node), ref(x.dest_node), x.source_actor,
+          x.dest_actor, x.mid, x.type_token, x.size, x.received ? 1u : 0u});
+}
+
+void export_writer::add(uint64_t time, const traffic_delta& x) {
+  auto node = ref(x.source_node);
+  for (auto& y : x.actors)
+    append(export_table::actor_traffic,
+           {time, node, y.source_actor, ref(y.dest_node), y.dest_actor,
+            y.messages, y.bytes});
+  for (auto& y : x.nodes)
+    append(export_table::node_traffic,
+           {time, node, ref(y.dest_node), y.messages, y.bytes});
+}
+
+void export_writer::add(uint64_t time, const ram_usage& x) {
+  append(export_table::ram,
+         {time, ref(x.source_node), x.in_use, x.available});
+}
+
+void export_writer::add(uint64_t time, const work_load& x) {
+  append(export_table::load,
+         {time, ref(x.source_node), x.cpu_load, x.num_processes,
+          x.num_actors});
+}
+
+void export_writer::add(uint64_t time, const new_route& x) {
+  append(export_table::routes,
+         {time, ref(x.source_node), ref(x.dest), x.is_direct ? 2u : 1u});
+}
+
+void export_writer::add(uint64_t time, const route_lost& x) {
+  append(export_table::routes, {time, ref(x.source_node), ref(x.dest), 0});
+}
+
+bool export_writer::flush() {
+  auto result = true;
+  for (size_t i = 1; i < export_tables; ++i)
+    if (! write_block(static_cast<export_table>(i)))
+      result = false;
+  if (! result || max_file_size_ == 0 || offset_ < max_file_size_)
+    return result;
+  // all pending rows are written, i.e., no row refers to the node IDs of
+  // the current file and we can safely start the next one
+  close();
+  ++seq_;
+  return true;
+}
+
+void export_writer::close() {
+  for (size_t i = 1; i < export_tables; ++i)
+    write_block(static_cast<export_table>(i));
+  if (! out_.is_open())
+    return;
+  buf_.clear();
+  buf_.push_back(static_cast<char>(export_table::index));
+  write_varint(buf_, index_.size());
+  for (auto& x : index_) {
+    buf_.push_back(static_cast<char>(x.table));
+    write_varint(buf_, x.offset);
+    write_varint(buf_, x.rows);
+    write_varint(buf_, x.min_time);
+    write_varint(buf_, x.max_time);
+  }
+  for (int n = 0; n < 8; ++n)
+    buf_.push_back(static_cast<char>((offset_ >> (n * 8)) & 0xFF));
+  buf_.insert(buf_.end(), index_magic, index_magic + magic_size);
+  write(buf_);
+  out_.close();
+  ids_.clear();
+  new_nodes_.clear();
+  index_.clear();
+}
+
+std::string export_writer::current_file() const {
+  if (max_file_size_ == 0)
+    return path_;
+  return path_ + "." + std::to_string(seq_);
+}
+
+void export_writer::append(export_table t,
+                           std::initializer_list<uint64_t> row) {
+  auto& cols = tables_[static_cast<size_t>(t)];
+  auto i = cols.begin();
+  for (auto x : row)
+    (i++)->push_back(x);
+  if (cols.front().size() >= block_rows_)
+    write_block(t);
+}
+
+uint64_t export_writer::ref(const node_id& x) {
+  if (x == invalid_node_id)
+    return 0;
+  auto i = ids_.find(x);
+  if (i != ids_.end())
+    return i->second;
+  auto result = ids_.size() + 1;
+  ids_.emplace(x, result);
+  new_nodes_.push_back(x);
+  return result;
+}
+
+bool export_writer::open() {
+  if (out_.is_open())
+    return true;
+  if (max_file_size_ > 0 && max_files_ > 0 && seq_ >= max_files_) {
+    auto expired = path_ + "." + std::to_string(seq_ - max_files_);
+    std::remove(expired.c_str());
+  }
+  out_.clear();
+  out_.open(current_file(), std::ios::binary | std::ios::trunc);
+  if (! out_)
+    return false;
+  offset_ = 0;
+  buf_.assign(file_magic, file_magic + magic_size);
+  return write(buf_);
+}
+
+bool export_writer::write_nodes() {
+  if (new_nodes_.empty())
+    return true;
+  buf_.clear();
+  buf_.push_back(static_cast<char>(export_table::nodes));
+  write_varint(buf_, new_nodes_.size());
+  std::vector<char> payload;
+  write_varint(payload, ids_.size() - new_nodes_.size() + 1);
+  for (auto& x : new_nodes_) {
+    auto pid = x.process_id();
+    for (int n = 0; n < 4; ++n)
+      payload.push_back(static_cast<char>((pid >> (n * 8)) & 0xFF));
+    auto& hid = x.host_id();
+    payload.insert(payload.end(), hid.begin(), hid.end());
+  }
+  write_varint(buf_, payload.size());
+  buf_.insert(buf_.end(), payload.begin(), payload.end());
+  index_.push_back(export_block_info{export_table::nodes, offset_,
+                                     new_nodes_.size(), 0, 0});
+  new_nodes_.clear();
+  return write(buf_);
+}
+
+bool export_writer::write_block(export_table t) {
+  auto& cols = tables_[static_cast<size_t>(t)];
+  auto rows = cols.front().size();
+  if (rows == 0)
+    return true;
+  auto result = open() && write_nodes();
+  if (result) {
+    auto& times = cols.front();
+    auto minmax = std::minmax_element(times.begin(), times.end());
+    export_block_info info{t, offset_, rows, *minmax.first, *minmax.second};
+    std::vector<char> payload;
+    std::vector<char> column;
+    for (size_t i = 0; i < cols.size(); ++i) {
+      column.clear();
+      uint64_t last = 0;
+      for (auto x : cols[i]) {
+        if (i == 0) {
+          write_varint(column, zigzag(static_cast<int64_t>(x - last)));
+          last = x;
+        } else {
+          write_varint(column, x);
+        }
+      }
+      write_varint(payload, column.size());
+      payload.insert(payload.end(), column.begin(), column.end());
+    }
+    buf_.clear();
+    buf_.push_back(static_cast<char>(t));
+    write_varint(buf_, rows);
+    write_varint(buf_, payload.size());
+    buf_.insert(buf_.end(), payload.begin(), payload.end());
+    result = write(buf_);
+    if (result)
+      index_.push_back(info);
+  }
+  for (auto& col : cols)
+    col.clear();
+  return result;
+}
+
+bool export_writer::write(const std::vector<char>& buf) {
+  if (! out_.write(buf.data(), static_cast<std::streamsize>(buf.size()))
+      || ! out_.flush())
+    return false;
+  offset_ += buf.size();
+  return true;
+}
+
+export_reader::export_reader() : seekable_(true), pos_(0) {
+  // nop
+}
+
+bool export_reader::open(const std::string& path) {
+  if (in_.is_open())
+    in_.close();
+  in_.clear();
+  nodes_.clear();
+  blocks_.clear();
+  in_.open(path, std::ios::binary);
+  char magic[magic_size];
+  if (! in_ || ! in_.read(magic, magic_size)
+      || memcmp(magic, file_magic, magic_size) != 0)
+    return false;
+  pos_ = magic_size;
+# ifndef CAF_WINDOWS
+  struct stat st;
+  seekable_ = stat(path.c_str(), &st) == 0 && ! S_ISFIFO(st.st_mode);
+# else
+  seekable_ = true;
+# endif
+  if (! seekable_)
+    return true;
+  if (! read_index()) {
+    nodes_.clear();
+    blocks_.clear();
+    pos_ = magic_size;
+    if (! scan())
+      return false;
+  }
+  pos_ = magic_size;
+  return true;
+}
+
+const node_id& export_reader::node(uint64_t ref) const {
+  if (ref == 0 || ref > nodes_.size())
+    return invalid_node_id;
+  return nodes_[ref - 1];
+}
+
+bool export_reader::read(const export_block_info& x, export_block& out,
+                         uint64_t mask) {
+  if (! seekable_)
+    return false;
+  auto pos = pos_;
+  in_.clear();
+  in_.seekg(static_cast<std::streamoff>(x.offset));
+  pos_ = x.offset;
+  auto done = false;
+  auto result = read_block(out, mask, done) && out.table == x.table;
+  pos_ = pos;
+  return result;
+}
+
+bool export_reader::next(export_block& out, uint64_t mask) {
+  for (;;) {
+    if (seekable_) {
+      in_.clear();
+      in_.seekg(static_cast<std::streamoff>(pos_));
+    }
+    auto done = false;
+    if (! read_block(out, mask, done))
+      return false;
+    if (out.table != export_table::nodes)
+      return true;
+  }
+}
+
+bool export_reader::read_block(export_block& out, uint64_t mask,
+                               bool& done) {
+  auto tag = in_.get();
+  if (tag == std::char_traits<char>::eof())
+    return false;
+  ++pos_;
+  if (static_cast<uint8_t>(tag) == static_cast<uint8_t>(export_table::index)) {
+    done = true;
+    return false;
+  }
+  uint64_t size;
+  if (! valid_table(static_cast<uint8_t>(tag))
+      || ! read(out.rows) || ! read(size)
+      || size > static_cast<uint64_t>(std::numeric_limits<int32_t>::max()))
+    return false;
+  buf_.resize(size);
+  if (! in_.read(buf_.data(), static_cast<std::streamsize>(size)))
+    return false;
+  pos_ += size;
+  out.table = static_cast<export_table>(tag);
+  auto pos = static_cast<const char*>(buf_.data());
+  auto last = pos + buf_.size();
+  if (out.table == export_table::nodes) {
+    uint64_t first;
+    if (! read_varint(pos, last, first) || first == 0
+        || static_cast<uint64_t>(last - pos)
+           != out.rows * (4 + host_id_size))
+      return false;
+    if (nodes_.size() < first - 1 + out.rows)
+      nodes_.resize(first - 1 + out.rows);
+    for (uint64_t i = 0; i < out.rows; ++i) {
+      uint32_t pid = 0;
+      for (int n = 0; n < 4; ++n)
+        pid |= static_cast<uint32_t>(static_cast<uint8_t>(*pos++)) << (n * 8);
+      node_id::host_id_type hid;
+      memcpy(hid.data(), pos, host_id_size);
+      pos += host_id_size;
+      nodes_[first - 1 + i] = node_id{pid, hid};
+    }
+    out.columns.clear();
+    return true;
+  }
+  auto width = column_count(out.table);
+  out.columns.resize(width);
+  for (size_t i = 0; i < width; ++i) {
+    auto& col = out.columns[i];
+    col.clear();
+    uint64_t len;
+    if (! read_varint(pos, last, len)
+        || len > static_cast<uint64_t>(last - pos))
+      return false;
+    auto end = pos + len;
+    if (i >= 64 || (mask & (uint64_t{1} << i)) == 0) {
+      pos = end;
+      continue;
+    }
+    col.reserve(out.rows);
+    uint64_t prev = 0;
+    for (uint64_t row = 0; row < out.rows; ++row) {
+      uint64_t x;
+      if (! read_varint(pos, end, x))
+        return false;
+      if (i == 0) {
+        prev += static_cast<uint64_t>(unzigzag(x));
+        x = prev;
+      }
+      col.push_back(x);
+    }
+    if (pos != end)
+      return false;
+  }
+  return pos == last;
+}
+
+bool export_reader::read_index() {
+  in_.clear();
+  in_.seekg(0, std::ios::end);
+  auto size = static_cast<uint64_t>(in_.tellg());
+  if (size < magic_size + trailer_size)
+    return false;
+  char trailer[trailer_size];
+  in_.seekg(static_cast<std::streamoff>(size - trailer_size));
+  if (! in_.read(trailer, trailer_size)
+      || memcmp(trailer + 8, index_magic, magic_size) != 0)
+    return false;
+  uint64_t offset = 0;
+  for (int n = 0; n < 8; ++n)
+    offset |= static_cast<uint64_t>(static_cast<uint8_t>(trailer[n]))
+              << (n * 8);
+  if (offset < magic_size || offset >= size - trailer_size)
+    return false;
+  in_.seekg(static_cast<std::streamoff>(offset));
+  pos_ = offset;
+  uint64_t count;
+  if (in_.get() != static_cast<uint8_t>(export_table::index) || ! read(count))
+    return false;
+  std::vector<export_block_info> xs;
+  for (uint64_t i = 0; i < count; ++i) {
+    auto tag = in_.get();
+    export_block_info x;
+    if (tag == std::char_traits<char>::eof()
+        || ! valid_table(static_cast<uint8_t>(tag))
+        || ! read(x.offset) || ! read(x.rows)
+        || ! read(x.min_time) || ! read(x.max_time)
+        || x.offset >= offset)
+      return false;
+    x.table = static_cast<export_table>(tag);
+    xs.push_back(x);
+  }
+  export_block tmp;
+  for (auto& x : xs) {
+    if (x.table != export_table::nodes)
+      blocks_.push_back(x);
+    else if (! read(x, tmp, 0))
+      return false;
+  }
+  return true;
+}
+
+bool export_reader::scan() {
+  // stops at the index or at a truncated block, which happens when
+  // reading a file while it is being written
+  export_block tmp;
+  for (;;) {
+    in_.clear();
+    in_.seekg(static_cast<std::streamoff>(pos_));
+    auto offset = pos_;
+    auto done = false;
+    if (! read_block(tmp, 1, done))
+      return true;
+    if (tmp.table == export_table::nodes || tmp.rows == 0)
+      continue;
+    auto& times = tmp.columns.front();
+    auto minmax = std::minmax_element(times.begin(), times.end());
+    blocks_.push_back(export_block_info{tmp.table, offset, tmp.rows,
+                                        *minmax.first, *minmax.second});
+  }
+}
+
+bool export_reader::read(uint64_t& x) {
+  x = 0;
+  for (int shift = 0; shift < 64; shift += 7) {
+    auto byte = in_.get();
+    if (byte == std::char_traits<char>::eof())
+      return false;
+    ++pos_;
+    x |= static_cast<uint64_t>(byte & 0x7F) << shift;
+    if ((byte & 0x80) == 0)
+      return true;
+  }
+  return false;
+}
+
+} // namespace riac
+} // namespace caf
@@ -0,0 +1,96 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2015                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#include "caf/riac/latency_histogram.hpp"
+
+#include <limits>
+#include <algorithm>
+
+namespace caf {
+namespace riac {
+
+constexpr size_t latency_histogram::sub_buckets;
+
+constexpr size_t latency_histogram::num_buckets;
+
+latency_histogram::latency_histogram() {
+  clear();
+}
+
+void latency_histogram::record(uint64_t x) {
+  ++buckets_[bucket(x)];
+  ++count_;
+  max_ = std::max(max_, x);
+}
+
+void latency_histogram::clear() {
+  buckets_.fill(0);
+  count_ = 0;
+  max_ = 0;
+}
+
+uint64_t latency_histogram::percentile(size_t p) const {
+  if (count_ == 0)
+    return 0;
+  // nearest-rank method
+  auto rank = std::max<uint64_t>(1, (count_ * p + 99) / 100);
+  uint64_t seen = 0;
+  for (size_t i = 0; i < num_buckets; ++i) {
+    seen += buckets_[i];
+    if (seen >= rank)
+      return std::min(upper_bound(i), max_);
+  }
+  return max_;
+}
+
+void latency_histogram::counts(std::vector<uint64_t>& out) const {
+  auto last = num_buckets;
+  while (last > 0 && buckets_[last - 1] == 0)
+    --last;
+  out.insert(out.end(), buckets_.begin(), buckets_.begin() + last);
+}
+
+size_t latency_histogram::bucket(uint64_t x) {
+  if (x < sub_buckets)
+    return static_cast<size_t>(x);
+  // position of the highest bit, at least 2
+  size_t exp = 0;
+  for (auto y = x; y > 1; y >>= 1)
+    ++exp;
+  auto sub = static_cast<size_t>(x >> (exp - 2)) & (sub_buckets - 1);
+  auto result = (exp - 1) * sub_buckets + sub;
+  return std::min(result, num_buckets - 1);
+}
+
+uint64_t latency_histogram::lower_bound(size_t i) {
+  if (i < sub_buckets)
+    return i;
+  auto exp = i / sub_buckets + 1;
+  auto sub = i % sub_buckets;
+  return static_cast<uint64_t>(sub_buckets + sub) << (exp - 2);
+}
+
+uint64_t latency_histogram::upper_bound(size_t i) {
+  // the last bucket also counts all values beyond its range
+  return i + 1 < num_buckets ? lower_bound(i + 1) - 1
+                             : std::numeric_limits<uint64_t>::max();
+}
+
+} // namespace riac
+} // namespace caf
@@ -0,0 +1,103 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2015                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#include "caf/riac/metrics_broker.hpp"
+
+#include <chrono>
+
+#include "caf/riac/nexus.hpp"
+
+namespace caf {
+namespace riac {
+
+namespace {
+
+// requests with larger headers are rejected
+constexpr size_t max_request_size = 8192;
+
+// time until a scrape fails if the nexus does not respond
+constexpr std::chrono::seconds scrape_timeout{5};
+
+// answers the only request of a connection and terminates its worker, since
+// closing our end does not produce a connection_closed_msg
+void respond(io::broker* self, io::connection_handle hdl,
+             const char* status, const std::string& body) {
+  std::string header = "HTTP/1.1 ";
+  header += status;
+  header += "\r\nContent-Type: text/plain; version=0.0.4"
+            "\r\nContent-Length: ";
+  header += std::to_string(body.size());
+  header += "\r\nConnection: close\r\n\r\n";
+  self->write(hdl, header.size(), header.data());
+  self->write(hdl, body.size(), body.data());
+  self->flush(hdl);
+  self->close(hdl);
+  self->quit();
+}
+
+} // namespace <anonymous>
+
+const char* metrics_worker_state::name = "riac_metrics_worker";
+
+behavior metrics_server(io::broker* self, actor nexus) {
+  return {
+    [=](const io::new_connection_msg& msg) {
+      self->fork(metrics_worker, msg.handle, nexus);
+    },
+    [=](const io::acceptor_closed_msg&) {
+      self->quit();
+    }
+  };
+}
+
+behavior metrics_worker(stateful_actor<metrics_worker_state, io::broker>* self,
+                        io::connection_handle hdl, actor nexus) {
+  self->configure_read(hdl, io::receive_policy::at_most(1024));
+  return {
+    [=](const io::new_data_msg& msg) {
+      auto& req = self->state.request;
+      req.insert(req.end(), msg.buf.begin(), msg.buf.end());
+      if (req.find("\r\n\r\n") == std::string::npos) {
+        if (req.size() > max_request_size)
+          respond(self, hdl, "431 Request Header Fields Too Large", "");
+        return;
+      }
+      // ignore anything after the first request
+      self->configure_read(hdl, io::receive_policy::at_most(0));
+      if (req.compare(0, 4, "GET ") != 0) {
+        respond(self, hdl, "405 Method Not Allowed", "");
+        return;
+      }
+      self->request(nexus, scrape_timeout, metrics_atom::value).then(
+        [=](const std::string& body) {
+          respond(self, hdl, "200 OK", body);
+        },
+        [=](const error&) {
+          respond(self, hdl, "503 Service Unavailable", "");
+        }
+      );
+    },
+    [=](const io::connection_closed_msg&) {
+      self->quit();
+    }
+  };
+}
+
+} // namespace riac
+} // namespace caf
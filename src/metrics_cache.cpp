@@ -0,0 +1,190 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2015                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#include "caf/riac/metrics_cache.hpp"
+
+namespace caf {
+namespace riac {
+
+namespace {
+
+struct metric_family {
+  const char* name;
+  const char* help;
+  // returns `false` if the metric is not available
+  bool (*get)(const probe_data& x, uint64_t& out);
+};
+
+bool cpu_load(const probe_data& x, uint64_t& out) {
+  if (! x.load)
+    return false;
+  out = x.load->cpu_load;
+  return true;
+}
+
+bool processes(const probe_data& x, uint64_t& out) {
+  if (! x.load)
+    return false;
+  out = x.load->num_processes;
+  return true;
+}
+
+bool actors(const probe_data& x, uint64_t& out) {
+  if (! x.load)
+    return false;
+  out = x.load->num_actors;
+  return true;
+}
+
+bool known_actors(const probe_data& x, uint64_t& out) {
+  out = x.known_actors.size();
+  return true;
+}
+
+bool published_actors(const probe_data& x, uint64_t& out) {
+  out = x.published_actors.size();
+  return true;
+}
+
+bool ram_in_use(const probe_data& x, uint64_t& out) {
+  if (! x.ram)
+    return false;
+  out = x.ram->in_use;
+  return true;
+}
+
+bool ram_available(const probe_data& x, uint64_t& out) {
+  if (! x.ram)
+    return false;
+  out = x.ram->available;
+  return true;
+}
+
+bool direct_routes(const probe_data& x, uint64_t& out) {
+  out = x.direct_routes.size();
+  return true;
+}
+
+// all metrics are gauges labeled with node ID and hostname
+const metric_family families[] = {
+  {"riac_cpu_load_percent", "CPU load of the node in percent.", cpu_load},
+  {"riac_processes", "Number of processes running on the node.", processes},
+  {"riac_actors", "Number of actors running on the node.", actors},
+  {"riac_known_actors", "Number of actors of the node known to the nexus.",
+   known_actors},
+  {"riac_published_actors", "Number of actors published by the node.",
+   published_actors},
+  {"riac_ram_in_use_bytes", "RAM in use on the node.", ram_in_use},
+  {"riac_ram_available_bytes", "RAM available on the node.", ram_available},
+  {"riac_direct_routes", "Number of direct connections of the node.",
+   direct_routes}
+};
+
+constexpr size_t num_families = sizeof(families) / sizeof(metric_family);
+
+// escapes backslashes, quotes and newlines in label values
+void append_label(std::string& out, const char* key,
+                  const std::string& value) {
+  out += key;
+  out += "=\"";
+  for (auto c : value) {
+    switch (c) {
+      case '\\':
+        out += "\\\\";
+        break;
+      case '"':
+        out += "\\\"";
+        break;
+      case '\n':
+        out += "\\n";
+        break;
+      default:
+        out += c;
+    }
+  }
+  out += '"';
+}
+
+} // namespace <anonymous>
+
+metrics_cache::metrics_cache() : dirty_(true) {
+  // nop
+}
+
+const std::string& metrics_cache::render(const probe_data_map& data) {
+  for (auto& kvp : data) {
+    auto i = nodes_.emplace(kvp.first, entry{0, {}});
+    if (i.second || i.first->second.version != kvp.second.version) {
+      render(kvp.first, kvp.second, i.first->second);
+      dirty_ = true;
+    }
+  }
+  // all nodes in `data` are cached, any additional entry is stale
+  if (nodes_.size() > data.size()) {
+    for (auto i = nodes_.begin(); i != nodes_.end();) {
+      if (data.count(i->first) == 0)
+        i = nodes_.erase(i);
+      else
+        ++i;
+    }
+    dirty_ = true;
+  }
+  if (! dirty_)
+    return body_;
+  body_.clear();
+  for (size_t i = 0; i < num_families; ++i) {
+    auto& family = families[i];
+    body_ += "# HELP ";
+    body_ += family.name;
+    body_ += ' ';
+    body_ += family.help;
+    body_ += "\n# TYPE ";
+    body_ += family.name;
+    body_ += " gauge\n";
+    for (auto& kvp : nodes_)
+      body_ += kvp.second.samples[i];
+  }
+  dirty_ = false;
+  return body_;
+}
+
+void metrics_cache::render(const node_id& nid, const probe_data& x,
+                           entry& out) {
+  std::string labels = "{";
+  append_label(labels, "node", to_string(nid));
+  labels += ',';
+  append_label(labels, "host", x.node.hostname);
+  labels += "} ";
+  out.version = x.version;
+  out.samples.resize(num_families);
+  for (size_t i = 0; i < num_families; ++i) {
+    auto& line = out.samples[i];
+    line.clear();
+    uint64_t value;
+    if (! families[i].get(x, value))
+      continue;
+    line += families[i].name;
+    line += labels;
+    line += std::to_string(value);
+    line += '\n';
+  }
+}
+
+} // namespace riac
+} // namespace caf
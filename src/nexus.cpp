@@ -19,10 +19,18 @@
 
 #include "caf/riac/nexus.hpp"
 
+#include <random>
 #include <iostream>
+#include <algorithm>
 
 #include "caf/actor_ostream.hpp"
 
+#include "caf/io/middleman.hpp"
+
+#include "caf/riac/config.hpp"
+#include "caf/riac/snapshot.hpp"
+#include "caf/riac/metrics_broker.hpp"
+
 using std::cerr;
 using std::endl;
 
@@ -38,19 +46,34 @@ using std::endl;
   static_cast<void>(0)
 
 #define HANDLE_UPDATE(TypeName, FieldName)                                     \
-  [=](const TypeName& FieldName) {                                             \
+  void nexus::handle(const TypeName& FieldName) {                              \
     if (FieldName.source_node == caf::invalid_node_id) {                       \
       cerr << #TypeName << " received with invalid source node" << endl;       \
       return;                                                                  \
     }                                                                          \
     if (! silent_)                                                             \
       aout(this) << "received " << #TypeName << endl;                          \
-    data_[FieldName.source_node].FieldName = FieldName;                        \
-    broadcast(FieldName);                                                      \
+    touch(FieldName.source_node).FieldName = FieldName;                        \
+    if (coalesce_interval_ > 0)                                                \
+      dirty_.add(FieldName);                                                   \
+    else                                                                       \
+      broadcast(FieldName);                                                    \
   }
 
 namespace {
 
+// returns a random, non-zero epoch for a new nexus instance
+uint64_t make_epoch() {
+  std::random_device rd;
+  auto t = std::chrono::steady_clock::now().time_since_epoch().count();
+  auto result = ((static_cast<uint64_t>(rd()) << 32) | rd())
+                ^ static_cast<uint64_t>(t);
+  return result != 0 ? result : 1;
+}
+
+// maximum number of removed nodes we keep track of for resuming listeners
+constexpr size_t max_removed_nodes = 10000;
+
 std::string format_down_msg(const std::string& type, const caf::down_msg& dm) {
   std::stringstream ds;
   ds << type << " "
@@ -64,15 +87,33 @@ std::string format_down_msg(const std::string& type, const caf::down_msg& dm) {
 namespace caf {
 namespace riac {
 
-nexus::nexus(actor_config& cfg, bool silent)
-    : nexus_type::base(cfg),
-      silent_(silent) {
+nexus::nexus(actor_config& cfg, bool silent, bool shard)
+    : nexus_actor_type::base(cfg),
+      silent_(silent),
+      shard_(shard),
+      max_queued_(std::max<size_t>(1, get_settings(home_system().config())
+                                      .listener_queue)),
+      version_(0),
+      epoch_(make_epoch()),
+      pruned_version_(0),
+      chunk_size_(std::max<size_t>(1, get_settings(home_system().config())
+                                      .snapshot_chunk_size)),
+      snapshot_version_(0),
+      snapshot_writer_(unsafe_actor_handle_init),
+      snapshot_pending_(false) {
+  auto& st = get_settings(home_system().config());
+  coalesce_interval_ = st.coalesce_interval;
+  snapshot_interval_ = std::max<size_t>(1, st.snapshot_interval);
+  // shards share the settings of the front, hence they never persist
+  if (! shard)
+    snapshot_path_ = st.snapshot_path;
   set_down_handler([=](down_msg& dm) {
     auto ptr = actor_cast<strong_actor_ptr>(dm.source);
     if (! ptr)
       return;
     auto hdl = actor_cast<listener_type>(std::move(ptr));
-    if (listeners_.erase(hdl) > 0) {
+    if (listeners_.erase(hdl)) {
+      flows_.erase(hdl);
       if (! silent_)
         aout(this) << format_down_msg("listener", dm) << endl;
       return;
@@ -81,25 +122,438 @@ nexus::nexus(actor_config& cfg, bool silent)
     if (probe_addr != probes_.end()) {
       if (! silent_)
         aout(this) << format_down_msg("probe", dm) << endl;
-      node_disconnected nd{probe_addr->second};
-      send(this, nd);
-      auto i = data_.find(probe_addr->second);
-      if (i != data_.end()
-          && i->second.known_actors.erase(probe_addr->first) > 0) {
-        return;
+      // a regional nexus reports on behalf of many nodes
+      for (auto& nid : probe_addr->second) {
+        decoders_.erase(std::make_pair(probe_addr->first, nid));
+        node_disconnected nd{nid};
+        send(this, nd);
+        auto i = data_.find(nid);
+        if (i != data_.end()
+            && i->second.known_actors.erase(probe_addr->first) > 0)
+          i->second.version = ++version_;
       }
+      probes_.erase(probe_addr);
     }
   });
 }
 
-void nexus::add(listener_type hdl) {
-  if (listeners_.insert(hdl).second) {
+void nexus::broadcast(const node_info& x) {
+  broadcast(node_info_events, x);
+}
+
+void nexus::broadcast(const node_disconnected& x) {
+  broadcast(node_disconnected_events, x);
+}
+
+void nexus::broadcast(const ram_usage& x) {
+  broadcast(ram_usage_events, x);
+}
+
+void nexus::broadcast(const work_load& x) {
+  broadcast(work_load_events, x);
+}
+
+void nexus::broadcast(const new_route& x) {
+  broadcast(new_route_events, x);
+}
+
+void nexus::broadcast(const route_lost& x) {
+  broadcast(route_lost_events, x);
+}
+
+void nexus::broadcast(const new_message& x) {
+  listeners_.visit(new_message_events, x.source_node,
+                   {x.source_actor, x.dest_actor},
+                   [&](const listener_type& hdl) { deliver(hdl, x); });
+  disconnect_exceeded();
+}
+
+void nexus::broadcast(const new_actor_published& x) {
+  listeners_.visit(new_actor_published_events, x.source_node,
+                   {x.published_actor->id()},
+                   [&](const listener_type& hdl) { deliver(hdl, x); });
+  disconnect_exceeded();
+}
+
+void nexus::broadcast(const traffic_delta& x) {
+  broadcast(traffic_delta_events, x);
+}
+
+void nexus::broadcast(const route_stats& x) {
+  broadcast(route_stats_events, x);
+}
+
+void nexus::broadcast(const actor_hotspots& x) {
+  broadcast(actor_hotspots_events, x);
+}
+
+void nexus::broadcast(const thread_load& x) {
+  broadcast(thread_load_events, x);
+}
+
+void nexus::add(listener_type hdl, subscription sub) {
+  auto since = sub.since;
+  auto epoch = sub.epoch;
+  auto credit = sub.credit;
+  auto policy = sub.policy;
+  if (listeners_.add(hdl, std::move(sub))) {
+    if (credit > 0)
+      flows_.emplace(hdl, flow_control<message>{policy, credit, max_queued_});
     monitor(hdl);
-    send(hdl, data_);
+    sync(hdl, since, epoch);
+  }
+}
+
+void nexus::disconnect_exceeded() {
+  // the listener keeps running, it only stops receiving events from us
+  for (auto& hdl : exceeded_) {
+    cerr << "disconnecting listener " << to_string(hdl)
+         << " without credit" << endl;
+    listeners_.erase(hdl);
+    flows_.erase(hdl);
+    demonitor(hdl);
+  }
+  exceeded_.clear();
+}
+
+void nexus::grant(const listener_type& hdl, uint32_t n) {
+  auto i = flows_.find(hdl);
+  if (i == flows_.end())
+    return;
+  auto dest = actor_cast<actor>(hdl);
+  auto send_queued = [&](message& x) {
+    send(dest, std::move(x));
+  };
+  // each chunk with the latest state of dirty nodes costs one credit, only
+  // the final chunk brings the listener up to date with our version
+  auto send_latest = [&](const std::vector<node_id>& nodes, bool last) {
+    state_delta chunk{last ? version_ : 0, epoch_, false, last && ! shard_,
+                      probe_data_map{}, {}};
+    for (auto& nid : nodes) {
+      auto k = data_.find(nid);
+      if (k != data_.end())
+        chunk.changed.emplace(nid, k->second);
+      else
+        chunk.removed.push_back(nid);
+    }
+    send(hdl, chunk);
+  };
+  i->second.grant(n, chunk_size_, send_queued, send_latest);
+}
+
+void nexus::render_flows(std::string& out) const {
+  auto family = [&](const char* name, const char* type, const char* help) {
+    out += "# HELP ";
+    out += name;
+    out += ' ';
+    out += help;
+    out += "\n# TYPE ";
+    out += name;
+    out += ' ';
+    out += type;
+    out += '\n';
+  };
+  auto sample = [&](const char* name, const listener_type& hdl,
+                    uint64_t value) {
+    out += name;
+    out += "{listener=\"";
+    out += to_string(hdl);
+    out += "\"} ";
+    out += std::to_string(value);
+    out += '\n';
+  };
+  family("riac_listener_dropped_events_total", "counter",
+         "Events dropped for a listener without credit.");
+  for (auto& kvp : flows_)
+    sample("riac_listener_dropped_events_total", kvp.first,
+           kvp.second.dropped());
+  family("riac_listener_queued_events", "gauge",
+         "Events queued for a listener without credit.");
+  for (auto& kvp : flows_)
+    sample("riac_listener_queued_events", kvp.first,
+           kvp.second.queued());
+  family("riac_listener_credit", "gauge",
+         "Remaining credit of a listener.");
+  for (auto& kvp : flows_)
+    sample("riac_listener_credit", kvp.first, kvp.second.credit());
+}
+
+void nexus::sync(listener_type& hdl, uint64_t since, uint64_t epoch) {
+  state_delta chunk;
+  chunk.version = version_;
+  chunk.epoch = epoch_;
+  // a listener with unknown version, from a pruned state, or from another
+  // instance of the nexus starts over
+  chunk.reset = since == 0 || epoch != epoch_ || since < pruned_version_
+                || since > version_;
+  if (chunk.reset)
+    since = 0;
+  if (shard_)
+    chunk.reset = false;
+  chunk.last = false;
+  auto ship = [&] {
+    send(hdl, chunk);
+    chunk.reset = false;
+    chunk.changed.clear();
+    chunk.removed.clear();
+  };
+  for (auto& kvp : data_) {
+    if (kvp.second.version <= since || ! listeners_.selects(hdl, kvp.first))
+      continue;
+    chunk.changed.emplace(kvp.first, kvp.second);
+    if (chunk.changed.size() == chunk_size_)
+      ship();
+  }
+  if (since > 0)
+    for (auto& kvp : removed_)
+      if (kvp.second > since)
+        chunk.removed.push_back(kvp.first);
+  chunk.last = ! shard_;
+  if (! shard_ || ! chunk.changed.empty() || ! chunk.removed.empty())
+    ship();
+}
+
+probe_data& nexus::touch(const node_id& nid) {
+  auto& result = data_[nid];
+  result.version = ++version_;
+  removed_.erase(nid);
+  return result;
+}
+
+bool nexus::remove(const node_id& nid) {
+  dirty_.erase(nid);
+  if (data_.erase(nid) == 0)
+    return false;
+  removed_[nid] = ++version_;
+  if (removed_.size() > max_removed_nodes) {
+    // drop the oldest removal and force old listeners to start over
+    auto i = std::min_element(removed_.begin(), removed_.end(),
+                              [](const std::pair<const node_id, uint64_t>& x,
+                                 const std::pair<const node_id, uint64_t>& y) {
+                                return x.second < y.second;
+                              });
+    pruned_version_ = i->second;
+    removed_.erase(i);
+  }
+  return true;
+}
+
+void nexus::restore() {
+  auto& st = get_settings(home_system().config());
+  uint64_t version = 0;
+  probe_data_map data;
+  if (! read_snapshot(home_system(), snapshot_path_, version, data))
+    return;
+  if (! silent_)
+    aout(this) << "restored " << data.size() << " nodes from "
+               << snapshot_path_ << endl;
+  version_ = version;
+  for (auto& kvp : data) {
+    kvp.second.version = ++version_;
+    restored_.insert(kvp.first);
+  }
+  data_ = std::move(data);
+  // listeners from the previous run start over
+  pruned_version_ = version_;
+  snapshot_version_ = version_;
+  restore_deadline_ = std::chrono::steady_clock::now()
+                      + std::chrono::milliseconds(st.snapshot_grace);
+}
+
+void nexus::tick() {
+  if (! restored_.empty()
+      && std::chrono::steady_clock::now() >= restore_deadline_) {
+    for (auto& nid : restored_)
+      send(this, node_disconnected{nid});
+    restored_.clear();
+  }
+  if (snapshot_pending_ || version_ == snapshot_version_)
+    return;
+  // only serialize here, the writer blocks on I/O instead of the nexus
+  auto version = version_;
+  snapshot_pending_ = true;
+  request(snapshot_writer_, infinite,
+          serialize_snapshot(home_system(), version, data_)).then(
+    [=](bool ok) {
+      snapshot_pending_ = false;
+      if (ok)
+        snapshot_version_ = version;
+      else
+        cerr << "unable to write snapshot to " << snapshot_path_ << endl;
+    }
+  );
+}
+
+void nexus::serve_metrics() {
+  auto port = get_settings(home_system().config()).metrics_port;
+  // a sharded nexus has no single state to render
+  if (shard_ || port == 0)
+    return;
+  auto res = home_system().middleman().spawn_server(metrics_server, port,
+                                                    actor_cast<actor>(this));
+  if (! res) {
+    cerr << "unable to serve metrics on port " << port << ": "
+         << home_system().render(res.error()) << endl;
+    return;
+  }
+  link_to(*res);
+  if (! silent_)
+    aout(this) << "serving metrics on port " << port << endl;
+}
+
+void nexus::flush_dirty() {
+  dirty_.flush([&](event_batch& batch) {
+    uint32_t present = (batch.ram.empty() ? 0 : ram_usage_events)
+                       | (batch.load.empty() ? 0 : work_load_events)
+                       | (batch.threads.empty() ? 0 : thread_load_events);
+    // collect the event types each listener selects from this node
+    std::map<listener_type, uint32_t> selected;
+    for (auto flag : {ram_usage_events, work_load_events, thread_load_events})
+      if ((present & flag) != 0)
+        listeners_.visit(flag, batch.source_node, {},
+                         [&](const listener_type& hdl) {
+                           selected[hdl] |= flag;
+                         });
+    for (auto& kvp : selected) {
+      if (kvp.second == present) {
+        deliver(kvp.first, batch);
+        continue;
+      }
+      event_batch subset;
+      subset.source_node = batch.source_node;
+      subset.dropped = 0;
+      if ((kvp.second & ram_usage_events) != 0)
+        subset.ram = batch.ram;
+      if ((kvp.second & work_load_events) != 0)
+        subset.load = batch.load;
+      if ((kvp.second & thread_load_events) != 0)
+        subset.threads = batch.threads;
+      deliver(kvp.first, subset);
+    }
+  });
+  disconnect_exceeded();
+}
+
+HANDLE_UPDATE(ram_usage, ram)
+
+HANDLE_UPDATE(work_load, load)
+
+HANDLE_UPDATE(thread_load, threads)
+
+void nexus::handle(const new_actor_published& msg) {
+  CHECK_SOURCE(actor_published, msg);
+  auto addr = msg.published_actor;
+  auto nid = msg.source_node;
+  if (! addr) {
+    cerr << "received actor_published "
+         << "with invalid actor address"
+         << endl;
+    return;
+  }
+  auto& entry = touch(nid);
+  if (entry.known_actors.insert(addr).second) {
+    monitor(addr);
+  }
+  entry.published_actors.insert(std::make_pair(addr, msg.port));
+  broadcast(msg);
+}
+
+void nexus::handle(const new_route& route) {
+  CHECK_SOURCE(new_route, route);
+  if (route.is_direct
+      && touch(route.source_node).direct_routes.insert(route.dest).second) {
+    broadcast(route);
+  }
+}
+
+void nexus::handle(const route_lost& route) {
+  CHECK_SOURCE(route_lost, route);
+  auto i = data_.find(route.source_node);
+  if (i != data_.end() && i->second.direct_routes.erase(route.dest) > 0) {
+    i->second.version = ++version_;
+    if (! silent_)
+      aout(this) << "new route" << endl;
+    broadcast(route);
   }
 }
 
+void nexus::handle(const new_message& msg) {
+  CHECK_SOURCE(new_message, msg);
+  if (! silent_)
+    aout(this) << "new message: " << to_string(msg) << endl;
+  broadcast(msg);
+}
+
+void nexus::handle(const traffic_delta& td) {
+  CHECK_SOURCE(traffic_delta, td);
+  if (td.dropped > 0)
+    cerr << "probe at " << to_string(td.source_node) << " did not count "
+         << td.dropped << " messages" << endl;
+  accumulate(touch(td.source_node), td);
+  broadcast(td);
+}
+
+void nexus::handle(const route_stats& rs) {
+  CHECK_SOURCE(route_stats, rs);
+  touch(rs.source_node).latencies[rs.dest] = rs;
+  broadcast(rs);
+}
+
+void nexus::handle(const actor_hotspots& ah) {
+  CHECK_SOURCE(actor_hotspots, ah);
+  touch(ah.source_node).hot_actors = ah.actors;
+  broadcast(ah);
+}
+
+void nexus::handle(const event_batch& batch) {
+  if (batch.dropped > 0)
+    cerr << "probe at " << to_string(batch.source_node) << " dropped "
+         << batch.dropped << " events" << endl;
+  for (auto& x : batch.ram)
+    handle(x);
+  for (auto& x : batch.load)
+    handle(x);
+  for (auto& x : batch.routes)
+    handle(x);
+  for (auto& x : batch.lost_routes)
+    handle(x);
+  for (auto& x : batch.messages)
+    handle(x);
+  for (auto& x : batch.published_actors)
+    handle(x);
+  for (auto& x : batch.traffic)
+    handle(x);
+  for (auto& x : batch.latencies)
+    handle(x);
+  for (auto& x : batch.hotspots)
+    handle(x);
+  for (auto& x : batch.threads)
+    handle(x);
+}
+
+void nexus::handle(const compact_batch& x) {
+  event_batch batch;
+  auto key = std::make_pair(current_element_->sender, x.source_node);
+  if (! decoders_[key].decode(x, batch)) {
+    cerr << "received malformed compact_batch from "
+         << to_string(x.source_node) << endl;
+    return;
+  }
+  handle(batch);
+}
+
 nexus::behavior_type nexus::make_behavior() {
+  if (! snapshot_path_.empty()) {
+    restore();
+    snapshot_writer_ = spawn<detached + linked>(snapshot_writer,
+                                                snapshot_path_);
+    delayed_send(this, std::chrono::milliseconds(snapshot_interval_),
+                 tick_atom::value);
+  }
+  serve_metrics();
+  if (coalesce_interval_ > 0)
+    delayed_send(this, std::chrono::milliseconds(coalesce_interval_),
+                 coalesce_atom::value);
   return {
     [=](const node_info& ni) {
       if (ni.source_node == caf::invalid_node_id) {
@@ -108,69 +562,129 @@ nexus::behavior_type nexus::make_behavior() {
       }
       if (! silent_)
         aout(this) << "received node_info: " << to_string(ni) << endl;
-      data_[ni.source_node].node = ni;
+      touch(ni.source_node).node = ni;
+      restored_.erase(ni.source_node);
+      listeners_.add_node(ni.source_node, ni.hostname);
       auto ls = current_element_->sender;
-      probes_[ls] = ls ? ls->node() : invalid_node_id;
+      probes_[ls].insert(ni.source_node);
       monitor(ls);
       broadcast(ni);
     },
-    HANDLE_UPDATE(ram_usage, ram),
-    HANDLE_UPDATE(work_load, load),
+    [=](const ram_usage& ram) {
+      handle(ram);
+    },
+    [=](const work_load& load) {
+      handle(load);
+    },
     [=](const new_actor_published& msg) {
-      CHECK_SOURCE(actor_published, msg);
-      auto addr = msg.published_actor;
-      auto nid = msg.source_node;
-      if (! addr) {
-        cerr << "received actor_published "
-             << "with invalid actor address"
-             << endl;
-        return;
-      }
-      if (data_[nid].known_actors.insert(addr).second) {
-        monitor(addr);
-      }
-      data_[nid].published_actors.insert(std::make_pair(addr, msg.port));
-      broadcast(msg);
+      handle(msg);
     },
     [=](const new_route& route) {
-      CHECK_SOURCE(new_route, route);
-      if (route.is_direct
-          && data_[route.source_node].direct_routes.insert(route.dest).second) {
-        broadcast(route);
-      }
+      handle(route);
     },
     [=](const route_lost& route) {
-      CHECK_SOURCE(route_lost, route);
-      if (data_[route.source_node].direct_routes.erase(route.dest) > 0) {
-        if (! silent_)
-          aout(this) << "new route" << endl;
-        broadcast(route);
-      }
+      handle(route);
     },
     [=](const new_message& msg) {
-      // TODO: reduce message size by avoiding the complete msg
-      CHECK_SOURCE(new_message, msg);
+      handle(msg);
+    },
+    [=](const traffic_delta& td) {
+      handle(td);
+    },
+    [=](const route_stats& rs) {
+      handle(rs);
+    },
+    [=](const actor_hotspots& ah) {
+      handle(ah);
+    },
+    [=](const thread_load& threads) {
+      handle(threads);
+    },
+    [=](const event_batch& batch) {
+      if (! silent_)
+        aout(this) << "received event_batch" << endl;
+      handle(batch);
+    },
+    [=](const compact_batch& x) {
       if (! silent_)
-        aout(this) << "new message: " << to_string(msg.msg) << endl;
-      broadcast(msg);
+        aout(this) << "received compact_batch" << endl;
+      handle(x);
+    },
+    [=](const region_summary& x) {
+      if (! silent_)
+        aout(this) << "received region_summary" << endl;
+      for (auto& y : x.compact)
+        handle(y);
+      for (auto& y : x.batches)
+        handle(y);
     },
     [=](add_atom, actor x) {
       if (! silent_)
         aout(this) << "new dynamically typed listener: "
                    << to_string(x) << endl;
-      add(actor_cast<listener_type>(std::move(x)));
+      add(actor_cast<listener_type>(std::move(x)), subscription{});
+    },
+    [=](add_atom, actor x, uint64_t since) {
+      if (! silent_)
+        aout(this) << "new dynamically typed listener: "
+                   << to_string(x) << " resuming from " << since << endl;
+      subscription sub;
+      sub.since = since;
+      add(actor_cast<listener_type>(std::move(x)), std::move(sub));
+    },
+    [=](add_atom, actor x, subscription& sub) {
+      if (! silent_)
+        aout(this) << "new dynamically typed listener: "
+                   << to_string(x) << " with subscription" << endl;
+      add(actor_cast<listener_type>(std::move(x)), std::move(sub));
     },
     [=](add_atom, listener_type x) {
       if (! silent_)
         aout(this) << "new statically typed listener: "
                    << to_string(x) << endl;
-      add(std::move(x));
+      add(std::move(x), subscription{});
+    },
+    [=](add_atom, listener_type x, uint64_t since) {
+      if (! silent_)
+        aout(this) << "new statically typed listener: "
+                   << to_string(x) << " resuming from " << since << endl;
+      subscription sub;
+      sub.since = since;
+      add(std::move(x), std::move(sub));
+    },
+    [=](add_atom, listener_type x, subscription& sub) {
+      if (! silent_)
+        aout(this) << "new statically typed listener: "
+                   << to_string(x) << " with subscription" << endl;
+      add(std::move(x), std::move(sub));
     },
     [=](const node_disconnected& nd) {
       if (! silent_)
         aout(this) << "node_disconnected: " << to_string(nd) << endl;
-      data_.erase(nd.source_node);
+      remove(nd.source_node);
       broadcast(nd);
+      listeners_.remove_node(nd.source_node);
+    },
+    [=](tick_atom) {
+      tick();
+      delayed_send(this, std::chrono::milliseconds(snapshot_interval_),
+                   tick_atom::value);
+    },
+    [=](coalesce_atom) {
+      flush_dirty();
+      delayed_send(this, std::chrono::milliseconds(coalesce_interval_),
+                   coalesce_atom::value);
+    },
+    [=](credit_atom, uint32_t n) {
+      grant(actor_cast<listener_type>(current_sender()), n);
+    },
+    [=](credit_atom, const listener_type& x, uint32_t n) {
+      grant(x, n);
+    },
+    [=](metrics_atom) -> std::string {
+      auto result = metrics_.render(data_);
+      render_flows(result);
+      return result;
     }
   };
 }
@@ -19,111 +19,263 @@
 
 #include "caf/riac/nexus_proxy.hpp"
 
+#include <iostream>
+
+using std::cerr;
+using std::endl;
+
 namespace caf {
 namespace riac {
 
+namespace {
+
+// forwards the current message to the nexus, which is unknown until it
+// sent us its state
+template <class... Ts>
+void upstream(nexus_proxy_type::stateful_pointer<nexus_proxy_state> self,
+              Ts&&... xs) {
+  if (! self->state.upstream) {
+    cerr << "nexus_proxy received no state from a nexus yet, dropped "
+         << to_string(self->current_message()) << endl;
+    return;
+  }
+  self->delegate(actor_cast<nexus_type>(self->state.upstream),
+                 std::forward<Ts>(xs)...);
+}
+
+} // namespace <anonymous>
+
 nexus_proxy_type::behavior_type
 nexus_proxy(nexus_proxy_type::stateful_pointer<nexus_proxy_state> self) {
+  auto& st = get_settings(self->home_system().config());
+  self->state.traces = trace_store{st.trace_store_size};
+  self->state.store = state_store{st.history_minutes, st.history_hours};
+  auto update = [=](const event_batch& batch) {
+    self->state.store.update(batch);
+    for (auto& x : batch.messages)
+      self->state.traces.add(x);
+  };
+  auto decode = [=](const compact_batch& x) {
+    event_batch batch;
+    auto key = std::make_pair(self->current_sender(), x.source_node);
+    if (self->state.decoders[key].decode(x, batch))
+      update(batch);
+  };
   return {
     // from sink_type
-    [=](node_info& ni) {
-      self->state.data[ni.source_node].node = std::move(ni);
+    [=](const node_info& ni) {
+      self->state.store.update(ni);
     },
-    [=](ram_usage& ru) {
-      self->state.data[ru.source_node].ram = std::move(ru);
+    [=](const ram_usage& ru) {
+      self->state.store.update(ru);
     },
-    [=](work_load& wl) {
-      self->state.data[wl.source_node].load = std::move(wl);
+    [=](const work_load& wl) {
+      self->state.store.update(wl);
     },
     [=](const new_route& route) {
-      if (route.is_direct)
-        self->state.data[route.source_node].direct_routes.insert(route.dest);
+      self->state.store.update(route);
     },
     [=](const route_lost& route) {
-      self->state.data[route.source_node].direct_routes.erase(route.dest);
+      self->state.store.update(route);
     },
-    [=](const new_message&) {
-      //aout(this) << "new message" << endl;
+    [=](const new_message& msg) {
+      self->state.traces.add(msg);
     },
     [=](const new_actor_published& msg) {
-      auto addr = msg.published_actor;
-      auto nid = msg.source_node;
-      if (! addr)
-        return;
-      self->state.data[nid].known_actors.insert(addr);
-      self->state.data[nid].published_actors.insert(std::make_pair(addr, msg.port));
+      self->state.store.update(msg);
+    },
+    [=](const traffic_delta& td) {
+      self->state.store.update(td);
+    },
+    [=](const route_stats& rs) {
+      self->state.store.update(rs);
+    },
+    [=](const actor_hotspots& ah) {
+      self->state.store.update(ah);
+    },
+    [=](const thread_load& tl) {
+      self->state.store.update(tl);
     },
     [=](const node_disconnected& nd) {
-      self->state.data.erase(nd.source_node);
+      self->state.store.erase(nd.source_node);
     },
     // from nexus_type
-    [=](add_atom, const actor&) {
-      // TODO
+    [=](const event_batch& batch) {
+      update(batch);
     },
-    [=](add_atom, const listener_type&) {
-      // TODO
+    [=](const compact_batch& x) {
+      decode(x);
+    },
+    [=](const region_summary& x) {
+      for (auto& y : x.compact)
+        decode(y);
+      for (auto& y : x.batches)
+        update(y);
+    },
+    // listeners and their credit are managed by the nexus we listen to
+    [=](add_atom atm, actor& x) {
+      upstream(self, atm, std::move(x));
+    },
+    [=](add_atom atm, actor& x, uint64_t since) {
+      upstream(self, atm, std::move(x), since);
+    },
+    [=](add_atom atm, listener_type& x) {
+      upstream(self, atm, std::move(x));
+    },
+    [=](add_atom atm, listener_type& x, uint64_t since) {
+      upstream(self, atm, std::move(x), since);
+    },
+    [=](add_atom atm, actor& x, subscription& sub) {
+      upstream(self, atm, std::move(x), std::move(sub));
+    },
+    [=](add_atom atm, listener_type& x, subscription& sub) {
+      upstream(self, atm, std::move(x), std::move(sub));
+    },
+    [=](credit_atom atm, uint32_t n) {
+      // delegating keeps the listener as sender
+      upstream(self, atm, n);
+    },
+    [=](credit_atom atm, listener_type& x, uint32_t n) {
+      upstream(self, atm, std::move(x), n);
     },
     // from nexus_proxy_type
     [=](probe_data_map& new_data) {
-      self->state.data = std::move(new_data);
+      self->state.upstream = self->current_sender();
+      self->state.store.assign(new_data);
+    },
+    [=](state_delta& delta) {
+      self->state.upstream = self->current_sender();
+      self->state.store.update(delta);
+      if (delta.last) {
+        self->state.version = delta.version;
+        self->state.epoch = delta.epoch;
+      }
     },
     [=](list_nodes) -> std::vector<node_id> {
       std::vector<node_id> result;
-      result.reserve(self->state.data.size());
-      for (auto& kvp : self->state.data)
+      result.reserve(self->state.store.size());
+      for (auto& kvp : self->state.store.nodes())
         result.push_back(kvp.first);
       return result;
     },
     [=](list_nodes, const std::string& hostname) -> std::vector<node_id> {
-      std::vector<node_id> result;
-      for (auto& kvp : self->state.data)
-        if (kvp.second.node.hostname == hostname)
-          result.push_back(kvp.first);
-      return result;
+      return self->state.store.nodes(hostname);
     },
     [=](get_node, const node_id& nid) -> result<node_info> {
-      auto i = self->state.data.find(nid);
-      if (i == self->state.data.end())
+      auto st = self->state.store.find(nid);
+      if (! st)
         return sec::no_such_riac_node;
-      return i->second.node;
+      return st->node;
     },
-    [=](list_peers, const node_id& ni) -> std::vector<node_id> {
-      std::vector<node_id> result;
-      auto kvp = self->state.data.find(ni);
-      if(kvp != self->state.data.end()) {
-        auto& direct_routes = kvp->second.direct_routes;
-        result.insert(result.end(), direct_routes.begin(), direct_routes.end());
+    [=](list_peers, const node_id& nid) -> std::vector<node_id> {
+      auto st = self->state.store.find(nid);
+      if (! st)
+        return {};
+      return st->routes;
+    },
+    [=](list_peers, const node_id& nid,
+        latency_atom) -> std::vector<route_stats> {
+      std::vector<route_stats> result;
+      auto st = self->state.store.find(nid);
+      if (! st)
+        return result;
+      // peers without measurements yet have no samples
+      for (auto& peer : st->routes) {
+        auto i = st->latencies.find(peer);
+        if (i != st->latencies.end())
+          result.push_back(i->second);
+        else
+          result.push_back(route_stats{nid, peer, 0, 0, 0, 0, 0, 0, 0});
       }
       return result;
     },
     [=](get_sys_load, const node_id& nid) -> result<work_load> {
-      auto i = self->state.data.find(nid);
-      if (i == self->state.data.end() || ! i->second.load)
+      auto st = self->state.store.find(nid);
+      if (! st || ! st->load)
         return sec::no_such_riac_node;
-      return *(i->second.load);
+      return *st->load;
+    },
+    [=](get_thread_load, const node_id& nid) -> result<thread_load> {
+      auto st = self->state.store.find(nid);
+      if (! st || ! st->threads)
+        return sec::no_such_riac_node;
+      return *st->threads;
     },
     [=](get_ram_usage, const node_id& nid) -> result<ram_usage> {
-      auto i = self->state.data.find(nid);
-      if (i == self->state.data.end() || ! i->second.ram)
+      auto st = self->state.store.find(nid);
+      if (! st || ! st->ram)
         return sec::no_such_riac_node;
-      return *(i->second.ram);
+      return *st->ram;
     },
     [=](list_actors, const node_id& nid) -> std::vector<strong_actor_ptr> {
       std::vector<strong_actor_ptr> result;
-      for (auto& addr : self->state.data[nid].known_actors)
-        result.push_back(addr);
+      auto st = self->state.store.find(nid);
+      if (st) {
+        result.reserve(st->actors.size());
+        for (auto& kvp : st->actors)
+          result.push_back(kvp.second);
+      }
       return result;
     },
     [=](get_actor, const node_id& nid, actor_id aid) -> strong_actor_ptr {
-      auto& known_actors = self->state.data[nid].known_actors;
-      auto last = known_actors.end();
-      auto pred = [aid](const strong_actor_ptr& addr) {
-        return addr && addr->id() == aid;
-      };
-      auto i = std::find_if(known_actors.begin(), last, pred);
-      if (i != last)
-        return *i;
-      return nullptr;
+      return self->state.store.find_actor(nid, aid);
+    },
+    [=](get_traffic) -> std::vector<node_traffic> {
+      std::vector<node_traffic> result;
+      for (auto& kvp : self->state.store.nodes())
+        for (auto& x : kvp.second.node_traffic_out)
+          result.push_back(x.second);
+      return result;
+    },
+    [=](get_traffic, const node_id& nid) -> std::vector<actor_traffic> {
+      std::vector<actor_traffic> result;
+      auto st = self->state.store.find(nid);
+      if (st)
+        for (auto& x : st->actor_traffic_out)
+          result.push_back(x.second);
+      return result;
+    },
+    [=](get_load_history, const node_id& nid, uint64_t from,
+        uint64_t to) -> std::vector<metric_point> {
+      std::vector<metric_point> result;
+      auto st = self->state.store.find(nid);
+      if (st)
+        st->cpu_load.range(from, to, result);
+      return result;
+    },
+    [=](get_ram_history, const node_id& nid, uint64_t from,
+        uint64_t to) -> std::vector<metric_point> {
+      std::vector<metric_point> result;
+      auto st = self->state.store.find(nid);
+      if (st)
+        st->ram_in_use.range(from, to, result);
+      return result;
+    },
+    [=](get_routes) -> std::vector<forwarding_stats> {
+      std::vector<forwarding_stats> result;
+      for (auto& kvp : self->state.store.nodes())
+        self->state.store.collect_routes(kvp.first, result);
+      return result;
+    },
+    [=](get_routes, const node_id& nid) -> std::vector<forwarding_stats> {
+      std::vector<forwarding_stats> result;
+      self->state.store.collect_routes(nid, result);
+      return result;
+    },
+    [=](get_slowest, uint32_t n) -> std::vector<actor_latency> {
+      std::vector<actor_latency> result;
+      self->state.store.slowest(n, result);
+      return result;
+    },
+    [=](get_trace, uint64_t id) -> std::vector<span_info> {
+      std::vector<span_info> result;
+      self->state.traces.trace(id, result);
+      return result;
+    },
+    [=](get_slow_traces, uint32_t n) -> std::vector<span_info> {
+      std::vector<span_info> result;
+      self->state.traces.slowest(n, result);
+      return result;
     }
   };
 }
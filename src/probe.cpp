@@ -25,14 +25,33 @@
 #include <unistd.h>
 #endif
 
+#include <map>
+#include <set>
+#include <mutex>
+#include <atomic>
+#include <algorithm>
+#include <chrono>
+#include <cctype>
+#include <cstdlib>
 #include <cstring>
 #include <fstream>
 #include <iostream>
+#include <streambuf>
 
 #include "caf/all.hpp"
 #include "caf/io/all.hpp"
+#include "caf/stream_serializer.hpp"
 
 #include "caf/riac/nexus.hpp"
+#include "caf/riac/config.hpp"
+#include "caf/riac/sampler.hpp"
+#include "caf/riac/topology.hpp"
+#include "caf/riac/proc_stats.hpp"
+#include "caf/riac/trace_rings.hpp"
+#include "caf/riac/event_buffer.hpp"
+#include "caf/riac/trace_store.hpp"
+#include "caf/riac/traffic_table.hpp"
+#include "caf/riac/latency_histogram.hpp"
 #include "caf/riac/add_message_types.hpp"
 
 #include "caf/io/network/interfaces.hpp"
@@ -42,6 +61,23 @@ namespace riac {
 
 namespace {
 
+using flush_atom = atom_constant<atom("flush")>;
+
+using traffic_atom = atom_constant<atom("traffic")>;
+
+using collect_atom = atom_constant<atom("collect")>;
+
+using threads_atom = atom_constant<atom("threads")>;
+
+using ping_atom = atom_constant<atom("riacPing")>;
+
+using report_atom = atom_constant<atom("report")>;
+
+// key of the ping responder in the actor registry of each node
+constexpr atom_value ping_responder_key = atom("riacPong");
+
+using std::chrono::milliseconds;
+
 // SUSv2 guarantees that "host names are limited to 255 bytes"
 static constexpr size_t max_hostname_size = 256;
 
@@ -55,139 +91,871 @@ std::string hostname() {
   return buffer;
 }
 
+// splits a comma-separated list, ignoring whitespace and empty entries
+std::vector<std::string> split(const std::string& str) {
+  std::vector<std::string> result;
+  std::string entry;
+  for (auto c : str) {
+    if (c == ',') {
+      if (! entry.empty())
+        result.push_back(std::move(entry));
+      entry.clear();
+    } else if (! isspace(static_cast<unsigned char>(c))) {
+      entry += c;
+    }
+  }
+  if (! entry.empty())
+    result.push_back(std::move(entry));
+  return result;
+}
+
+uint64_t timestamp() {
+  using namespace std::chrono;
+  auto t = system_clock::now().time_since_epoch();
+  return static_cast<uint64_t>(duration_cast<microseconds>(t).count());
+}
+
+// returns the microseconds since `t0`
+uint64_t elapsed(std::chrono::steady_clock::time_point t0) {
+  using namespace std::chrono;
+  auto t = steady_clock::now() - t0;
+  return static_cast<uint64_t>(duration_cast<microseconds>(t).count());
+}
+
+// identifies a pair of actors communicating with each other,
+// whereas the source always runs on the node of the probe
+struct actor_pair {
+  actor_id source_actor;
+  node_id dest_node;
+  actor_id dest_actor;
+};
+
+bool operator==(const actor_pair& x, const actor_pair& y) {
+  return x.source_actor == y.source_actor
+         && x.dest_actor == y.dest_actor
+         && x.dest_node == y.dest_node;
+}
+
+struct actor_pair_hash {
+  size_t operator()(const actor_pair& x) const {
+    std::hash<actor_id> h;
+    auto result = std::hash<node_id>{}(x.dest_node);
+    result = result * 31 + h(x.source_actor);
+    result = result * 31 + h(x.dest_actor);
+    return result;
+  }
+};
+
+// identifies messages from one node to another, optionally
+// combined with a `route_event_kind`
+struct route_key {
+  node_id from;
+  node_id to;
+  uint32_t kind;
+};
+
+bool operator==(const route_key& x, const route_key& y) {
+  return x.kind == y.kind && x.from == y.from && x.to == y.to;
+}
+
+struct route_key_hash {
+  size_t operator()(const route_key& x) const {
+    std::hash<node_id> h;
+    return (h(x.from) * 31 + h(x.to)) * 31 + x.kind;
+  }
+};
+
+// counts outgoing messages and bytes per destination, forwarded messages
+// per pair of nodes, and route events per pair of nodes and kind
+struct traffic_counters {
+  traffic_counters(size_t capacity)
+      : actors(capacity),
+        nodes(capacity),
+        forwarded(capacity),
+        events(capacity) {
+    // nop
+  }
+  traffic_table<actor_pair, actor_pair_hash> actors;
+  traffic_table<node_id> nodes;
+  traffic_table<route_key, route_key_hash> forwarded;
+  traffic_table<route_key, route_key_hash> events;
+};
+
+using traffic_counters_ptr = std::shared_ptr<traffic_counters>;
+
+// moves all message traces from the per-thread rings to the buffer
+void drain(trace_rings& rings, event_buffer& buf) {
+  std::vector<new_message> xs;
+  auto dropped = rings.drain(xs);
+  if (! xs.empty() || dropped > 0)
+    buf.push(xs, dropped);
+}
+
+// periodically drains message traces and ships events that did not fill up
+// an entire batch as well as traffic counters, whereas the latter is optional
+behavior flusher(event_based_actor* self, std::shared_ptr<event_buffer> buf,
+                 std::shared_ptr<trace_rings> rings,
+                 std::chrono::milliseconds flush_interval,
+                 traffic_counters_ptr counters,
+                 std::chrono::milliseconds traffic_interval) {
+  self->delayed_send(self, flush_interval, flush_atom::value);
+  if (counters)
+    self->delayed_send(self, traffic_interval, traffic_atom::value);
+  auto nid = self->home_system().node();
+  return {
+    [=](flush_atom) {
+      drain(*rings, *buf);
+      buf->flush();
+      self->delayed_send(self, flush_interval, flush_atom::value);
+    },
+    [=](traffic_atom) {
+      traffic_delta td;
+      td.source_node = nid;
+      td.dropped += counters->actors.collect([&](const actor_pair& x,
+                                                 uint64_t messages,
+                                                 uint64_t bytes) {
+        td.actors.push_back(actor_traffic{nid, x.source_actor, x.dest_node,
+                                          x.dest_actor, messages, bytes});
+      });
+      td.dropped += counters->nodes.collect([&](const node_id& x,
+                                                uint64_t messages,
+                                                uint64_t bytes) {
+        td.nodes.push_back(node_traffic{nid, x, messages, bytes});
+      });
+      td.dropped += counters->forwarded.collect([&](const route_key& x,
+                                                    uint64_t messages,
+                                                    uint64_t bytes) {
+        td.forwarded.push_back(forwarding_traffic{nid, x.from, x.to,
+                                                  messages, bytes});
+      });
+      td.dropped += counters->events.collect([&](const route_key& x,
+                                                 uint64_t count,
+                                                 uint64_t bytes) {
+        td.events.push_back(route_events{nid, x.from, x.to, x.kind,
+                                         count, bytes});
+      });
+      if (! td.nodes.empty() || ! td.forwarded.empty()
+          || ! td.events.empty() || td.dropped > 0) {
+        buf->push(std::move(td));
+        buf->flush();
+      }
+      self->delayed_send(self, traffic_interval, traffic_atom::value);
+    }
+  };
+}
+
+struct collector_state {
+  proc_stats stats;
+  static const char* name;
+};
+
+const char* collector_state::name = "riac_collector";
+
+// periodically reports RAM usage and work load of this node as well as
+// the CPU usage per thread, whereas either report is optional
+behavior collector(stateful_actor<collector_state>* self,
+                   std::shared_ptr<event_buffer> buf,
+                   std::chrono::milliseconds interval,
+                   std::chrono::milliseconds threads_interval) {
+  if (interval.count() > 0)
+    self->send(self, collect_atom::value);
+  if (threads_interval.count() > 0)
+    self->send(self, threads_atom::value);
+  return {
+    [=](collect_atom) {
+      auto& sys = self->home_system();
+      ram_usage ru{};
+      ru.source_node = sys.node();
+      if (self->state.stats.read(ru))
+        buf->push(std::move(ru));
+      work_load wl{};
+      wl.source_node = sys.node();
+      if (self->state.stats.read(wl)) {
+        wl.num_actors = sys.registry().running();
+        buf->push(std::move(wl));
+      }
+      self->delayed_send(self, interval, collect_atom::value);
+    },
+    [=](threads_atom) {
+      auto& sys = self->home_system();
+      thread_load tl;
+      tl.source_node = sys.node();
+      tl.num_workers = static_cast<uint32_t>(sys.config()
+                                             .scheduler_max_threads);
+      if (self->state.stats.read(tl))
+        buf->push(std::move(tl));
+      self->delayed_send(self, threads_interval, threads_atom::value);
+    }
+  };
+}
+
+// answers pings from other nodes with the size of the received payload
+behavior ping_responder(event_based_actor*) {
+  return {
+    [](ping_atom, const std::vector<char>& payload) -> uint64_t {
+      return payload.size();
+    }
+  };
+}
+
+// hands items from the hook to an actor, e.g., nodes the probe connected
+// to since the pinger checked last
+template <class T>
+class shared_queue {
+public:
+  void push(T x) {
+    std::unique_lock<std::mutex> guard{mtx_};
+    xs_.push_back(std::move(x));
+  }
+
+  std::vector<T> take() {
+    std::vector<T> result;
+    std::unique_lock<std::mutex> guard{mtx_};
+    result.swap(xs_);
+    return result;
+  }
+
+private:
+  std::mutex mtx_;
+  std::vector<T> xs_;
+};
+
+struct pinger_state {
+  struct peer {
+    strong_actor_ptr hdl;
+    std::vector<uint64_t> rtts; // in microseconds since the last report
+    uint32_t lost = 0;
+    uint64_t bandwidth = 0;
+    bool measured = false; // bandwidth since the last report
+  };
+  std::map<node_id, peer> peers;
+  static const char* name;
+};
+
+const char* pinger_state::name = "riac_pinger";
+
+// returns the p-th percentile of the sorted, non-empty `xs`
+uint64_t percentile(const std::vector<uint64_t>& xs, size_t p) {
+  auto rank = (xs.size() * p + 99) / 100;
+  return xs[rank > 0 ? rank - 1 : 0];
+}
+
+// periodically measures the round-trip time to the ping responders of all
+// directly connected nodes and estimates the bandwidth from the additional
+// time a ping with payload takes once per report; runs detached, because
+// looking up the responder of a new peer blocks
+behavior pinger(stateful_actor<pinger_state>* self,
+                std::shared_ptr<event_buffer> buf,
+                std::shared_ptr<shared_queue<node_id>> queue, settings st) {
+  using clock = std::chrono::steady_clock;
+  auto interval = milliseconds(st.ping_interval);
+  auto ping = [=](const node_id& nid, const strong_actor_ptr& hdl) {
+    auto dest = actor_cast<actor>(hdl);
+    auto t0 = clock::now();
+    self->request(dest, interval, ping_atom::value, std::vector<char>{}).then(
+      [=](uint64_t) {
+        auto rtt = elapsed(t0);
+        auto i = self->state.peers.find(nid);
+        if (i == self->state.peers.end())
+          return;
+        i->second.rtts.push_back(rtt);
+        if (st.ping_payload == 0 || i->second.measured)
+          return;
+        i->second.measured = true;
+        auto t1 = clock::now();
+        std::vector<char> payload(st.ping_payload);
+        self->request(dest, interval, ping_atom::value,
+                      std::move(payload)).then(
+          [=](uint64_t bytes) {
+            // the payload only travels one way
+            auto transfer = elapsed(t1);
+            auto j = self->state.peers.find(nid);
+            if (j != self->state.peers.end() && transfer > rtt)
+              j->second.bandwidth = bytes * 1000000 / (transfer - rtt);
+          },
+          [=](error&) {
+            // the next round measures again
+          }
+        );
+      },
+      [=](error&) {
+        auto i = self->state.peers.find(nid);
+        if (i != self->state.peers.end())
+          ++i->second.lost;
+      }
+    );
+  };
+  self->set_down_handler([=](down_msg& dm) {
+    auto ptr = actor_cast<strong_actor_ptr>(dm.source);
+    auto& peers = self->state.peers;
+    for (auto i = peers.begin(); i != peers.end(); ++i) {
+      if (i->second.hdl == ptr) {
+        peers.erase(i);
+        return;
+      }
+    }
+  });
+  self->send(self, tick_atom::value);
+  self->delayed_send(self, milliseconds(st.ping_report_interval),
+                     report_atom::value);
+  return {
+    [=](tick_atom) {
+      auto& mm = self->home_system().middleman();
+      for (auto& nid : queue->take()) {
+        if (self->state.peers.count(nid) > 0)
+          continue;
+        // nodes without probe have no responder and are not measured
+        auto hdl = mm.remote_lookup(ping_responder_key, nid);
+        if (! hdl)
+          continue;
+        self->monitor(hdl);
+        self->state.peers[nid].hdl = std::move(hdl);
+      }
+      for (auto& kvp : self->state.peers)
+        ping(kvp.first, kvp.second.hdl);
+      self->delayed_send(self, interval, tick_atom::value);
+    },
+    [=](report_atom) {
+      auto source = self->home_system().node();
+      for (auto& kvp : self->state.peers) {
+        auto& p = kvp.second;
+        route_stats rs{source, kvp.first, 0, p.lost, 0, 0, 0, 0,
+                       p.bandwidth};
+        auto& xs = p.rtts;
+        if (! xs.empty()) {
+          std::sort(xs.begin(), xs.end());
+          rs.samples = static_cast<uint32_t>(xs.size());
+          rs.rtt_p50 = percentile(xs, 50);
+          rs.rtt_p90 = percentile(xs, 90);
+          rs.rtt_p99 = percentile(xs, 99);
+          rs.rtt_max = xs.back();
+        }
+        if (rs.samples > 0 || rs.lost > 0)
+          buf->push(std::move(rs));
+        xs.clear();
+        p.lost = 0;
+        p.measured = false;
+      }
+      self->delayed_send(self, milliseconds(st.ping_report_interval),
+                         report_atom::value);
+    }
+  };
+}
+
+struct profiler_state {
+  struct target {
+    strong_actor_ptr hdl;
+    std::string name;
+    latency_histogram sojourn; // in microseconds since the last report
+    bool pending = false; // whether a measurement is in flight
+  };
+  std::map<actor_id, target> targets;
+  static const char* name;
+};
+
+const char* profiler_state::name = "riac_profiler";
+
+// periodically measures the mailbox sojourn time of published and
+// configured actors by timing an info request, which waits behind all
+// enqueued messages, and reports the actors with the highest 99th
+// percentile; CAF offers no thread-safe access to mailbox sizes and no
+// hooks for message processing, hence the sojourn time reflects both
+behavior profiler(stateful_actor<profiler_state>* self,
+                  std::shared_ptr<event_buffer> buf,
+                  std::shared_ptr<shared_queue<strong_actor_ptr>> queue,
+                  settings st) {
+  auto interval = milliseconds(st.profile_interval);
+  auto add = [=](strong_actor_ptr hdl) {
+    if (! hdl || hdl->node() != self->node()
+        || self->state.targets.count(hdl->id()) > 0)
+      return;
+    self->monitor(hdl);
+    auto aid = hdl->id();
+    self->state.targets[aid].hdl = std::move(hdl);
+  };
+  auto& reg = self->home_system().registry();
+  for (auto& x : split(st.profile_actors))
+    add(reg.get(std::strtoull(x.c_str(), nullptr, 10)));
+  auto measure = [=](actor_id aid, const strong_actor_ptr& hdl) {
+    auto t0 = std::chrono::steady_clock::now();
+    self->request(actor_cast<actor>(hdl), interval, sys_atom::value,
+                  get_atom::value, std::string{"info"}).then(
+      [=](ok_atom, const std::string&, const strong_actor_ptr&,
+          const std::string& name) {
+        auto i = self->state.targets.find(aid);
+        if (i == self->state.targets.end())
+          return;
+        i->second.sojourn.record(elapsed(t0));
+        i->second.name = name;
+        i->second.pending = false;
+      },
+      [=](error&) {
+        // an actor that did not answer in time took at least `interval`
+        auto i = self->state.targets.find(aid);
+        if (i == self->state.targets.end())
+          return;
+        i->second.sojourn.record(elapsed(t0));
+        i->second.pending = false;
+      }
+    );
+  };
+  self->set_down_handler([=](down_msg& dm) {
+    self->state.targets.erase(dm.source.id());
+  });
+  self->send(self, tick_atom::value);
+  self->delayed_send(self, milliseconds(st.profile_report_interval),
+                     report_atom::value);
+  return {
+    [=](tick_atom) {
+      for (auto& x : queue->take())
+        add(std::move(x));
+      for (auto& kvp : self->state.targets) {
+        if (! kvp.second.pending) {
+          kvp.second.pending = true;
+          measure(kvp.first, kvp.second.hdl);
+        }
+      }
+      self->delayed_send(self, interval, tick_atom::value);
+    },
+    [=](report_atom) {
+      actor_hotspots ah;
+      ah.source_node = self->node();
+      for (auto& kvp : self->state.targets) {
+        auto& h = kvp.second.sojourn;
+        if (h.count() == 0)
+          continue;
+        actor_latency x{ah.source_node, kvp.first, kvp.second.name,
+                        h.count(), h.percentile(50), h.percentile(90),
+                        h.percentile(99), h.max(), {}};
+        h.counts(x.buckets);
+        ah.actors.push_back(std::move(x));
+        h.clear();
+      }
+      auto slower = [](const actor_latency& x, const actor_latency& y) {
+        return x.p99 > y.p99;
+      };
+      std::sort(ah.actors.begin(), ah.actors.end(), slower);
+      if (ah.actors.size() > st.hot_actors)
+        ah.actors.resize(st.hot_actors);
+      if (! self->state.targets.empty())
+        buf->push(std::move(ah));
+      self->delayed_send(self, milliseconds(st.profile_report_interval),
+                         report_atom::value);
+    }
+  };
+}
+
+node_info make_node_info(actor_system& sys) {
+  node_info ni;
+  ni.source_node = sys.node();
+  ni.interfaces = io::network::interfaces::list_all();
+  ni.hostname = hostname();
+  ni.cpu = cpu_topology(ni.source_node);
+  ni.os = os_version();
+  return ni;
+}
+
+struct connector_state {
+  connector_state() : uplink(unsafe_actor_handle_init) {
+    // nop
+  }
+  nexus_type uplink;
+  milliseconds delay;
+  static const char* name;
+};
+
+const char* connector_state::name = "riac_connector";
+
+// connects to the nexus in the background, reconnecting with exponential
+// backoff whenever a connection attempt fails or the nexus goes down;
+// also serves as sender of all events, i.e., the nexus considers this
+// node disconnected once this actor terminates
+behavior connector(stateful_actor<connector_state>* self,
+                   std::shared_ptr<event_buffer> buf,
+                   std::string host, uint16_t port, settings st) {
+  self->state.delay = milliseconds(st.reconnect_delay);
+  auto retry = [=] {
+    auto& delay = self->state.delay;
+    self->delayed_send(self, delay, connect_atom::value);
+    delay = std::min(delay * 2, milliseconds(st.max_reconnect_delay));
+  };
+  self->set_down_handler([=](down_msg& dm) {
+    if (dm.source != self->state.uplink.address())
+      return;
+    CAF_LOG_INFO("lost connection to nexus:" << CAF_ARG(dm.reason));
+    buf->disconnect();
+    self->state.uplink = nexus_type{unsafe_actor_handle_init};
+    retry();
+  });
+  self->send(self, connect_atom::value);
+  return {
+    [=](connect_atom) {
+      auto mm = self->home_system().middleman().actor_handle();
+      self->request(mm, milliseconds(st.connect_timeout),
+                    connect_atom::value, host, port).then(
+        [=](const node_id&, strong_actor_ptr& ptr,
+            const std::set<std::string>&) {
+          if (! ptr) {
+            CAF_LOG_ERROR("nexus is not an actor:"
+                          << CAF_ARG(host) << CAF_ARG(port));
+            retry();
+            return;
+          }
+          auto uplink = actor_cast<nexus_type>(std::move(ptr));
+          self->monitor(uplink);
+          self->send(uplink, make_node_info(self->home_system()));
+          buf->connect(uplink, actor_cast<strong_actor_ptr>(self));
+          self->state.uplink = std::move(uplink);
+          self->state.delay = milliseconds(st.reconnect_delay);
+        },
+        [=](error& err) {
+          CAF_LOG_ERROR("could not connect to nexus:"
+                        << CAF_ARG(host) << CAF_ARG(port)
+                        << CAF_ARG(self->home_system().render(err)));
+          retry();
+        }
+      );
+    }
+  };
+}
+
+// counts the bytes written by a serializer without storing them
+class byte_counter : public std::streambuf {
+public:
+  byte_counter() : count_(0) {
+    // nop
+  }
+
+  size_t count() const {
+    return count_;
+  }
+
+protected:
+  std::streamsize xsputn(const char_type*, std::streamsize n) override {
+    count_ += static_cast<size_t>(n);
+    return n;
+  }
+
+  int_type overflow(int_type c) override {
+    if (! traits_type::eq_int_type(c, traits_type::eof()))
+      ++count_;
+    return traits_type::not_eof(c);
+  }
+
+private:
+  size_t count_;
+};
+
 class fwd_hook : public io::hook {
 public:
   fwd_hook(actor_system& sys)
       : io::hook(sys),
-        self_(sys, true),
-        uplink_(unsafe_actor_handle_init),
-        node_(sys.node()) {
-    // nop
+        sys_(sys),
+        node_(sys.node()),
+        buf_(std::make_shared<event_buffer>(
+          node_, get_settings(sys.config()).batch_size,
+          get_settings(sys.config()).max_pending,
+          get_settings(sys.config()).compact_wire)),
+        rings_(std::make_shared<trace_rings>(
+          get_settings(sys.config()).ring_size)),
+        peers_(std::make_shared<shared_queue<node_id>>()),
+        published_(std::make_shared<shared_queue<strong_actor_ptr>>()),
+        captured_(0),
+        sampler_(get_settings(sys.config())),
+        responder_id_(invalid_actor_id),
+        pinger_id_(invalid_actor_id) {
+    auto& st = get_settings(sys.config());
+    trace_messages_ = st.trace_messages;
+    measure_sizes_ = st.measure_sizes;
+    if (st.traffic_interval > 0)
+      counters_ = std::make_shared<traffic_counters>(st.traffic_table_size);
+    for (auto& x : split(st.capture_actors))
+      capture_actors_.insert(std::strtoull(x.c_str(), nullptr, 10));
+    for (auto& x : split(st.capture_types))
+      capture_types_.insert(std::move(x));
+    capture_rate_ = st.capture_rate > 0 ? st.capture_rate : 1;
+    span_rate_ = st.span_rate;
   }
 
-  void register_at_nexus(nexus_type uplink) {
-    CAF_ASSERT(self_.home_system().node() != invalid_node_id);
-    uplink_ = std::move(uplink);
-    node_info ni;
-    ni.source_node = self_.home_system().node();
-    ni.interfaces = io::network::interfaces::list_all();
-    ni.hostname = hostname();
-    self_->request(uplink_, infinite, std::move(ni)).receive(
-      [] {
-        // nop
-      }
-    );
+  const std::shared_ptr<event_buffer>& buffer() const {
+    return buf_;
+  }
+
+  const std::shared_ptr<trace_rings>& rings() const {
+    return rings_;
+  }
+
+  const traffic_counters_ptr& counters() const {
+    return counters_;
+  }
+
+  const std::shared_ptr<shared_queue<node_id>>& peers() const {
+    return peers_;
   }
 
-  node_id node(const strong_actor_ptr& x) {
-    return x ? invalid_node_id : x->node();
+  const std::shared_ptr<shared_queue<strong_actor_ptr>>& published() const {
+    return published_;
   }
 
   actor_id id(const strong_actor_ptr& x) {
-    return x ? invalid_actor_id : x->id();
+    return x ? x->id() : invalid_actor_id;
+  }
+
+  // excludes pings from traces and traffic counters
+  void ignore_pings(actor_id responder, actor_id pinger) {
+    responder_id_ = responder;
+    pinger_id_ = pinger;
   }
 
   template<class T, class... Ts>
   void transmit(Ts&&... args) {
-    if (! uplink_.unsafe())
-      self_->send(uplink_, T{std::forward<Ts>(args)...});
+    buf_->push(T{std::forward<Ts>(args)...});
   }
 
-  void message_received_cb(const node_id&, const strong_actor_ptr& from,
-                           const strong_actor_ptr& dest, message_id,
+  void message_received_cb(const node_id& source, const strong_actor_ptr& from,
+                           const strong_actor_ptr& dest, message_id mid,
                            const message& msg) override {
-    transmit<new_message>(node(from), node(dest), id(from), id(dest), msg);
+    if (is_ping(from) || is_ping(dest))
+      return;
+    if (trace_messages_
+        && (span_selected(from, dest, mid) || sampler_.select(id(dest))))
+      trace(source, node_, from, dest, mid, msg, payload_size(msg), true);
   }
 
-  void message_sent_cb(const strong_actor_ptr& from, const node_id&,
-                       const strong_actor_ptr& dest, message_id,
+  void message_sent_cb(const strong_actor_ptr& from, const node_id& dest_node,
+                       const strong_actor_ptr& dest, message_id mid,
                        const message& msg) override {
     // avoid endless recursion
-    if (uplink_.unsafe() || dest == uplink_)
+    if (buf_->is_uplink(dest))
+      return;
+    // pings measure the network and are no application traffic
+    if (is_ping(from) || is_ping(dest))
+      return;
+    auto sampled = trace_messages_ && (span_selected(from, dest, mid)
+                                       || sampler_.select(id(dest)));
+    if (! sampled && ! counters_)
       return;
-    transmit<new_message>(node(from), node(dest), id(from), id(dest), msg);
+    auto size = sampled || measure_sizes_ ? payload_size(msg) : 0;
+    if (counters_) {
+      counters_->actors.add(actor_pair{id(from), dest_node, id(dest)}, size);
+      counters_->nodes.add(dest_node, size);
+    }
+    if (sampled)
+      trace(node_, dest_node, from, dest, mid, msg, size, false);
   }
 
-  void message_forwarded_cb(const io::basp::header&,
-                            const std::vector<char>*) override {
-    // do nothing (yet)
+  void message_forwarded_cb(const io::basp::header& hdr,
+                            const std::vector<char>* payload) override {
+    if (counters_)
+      counters_->forwarded.add(route_key{hdr.source_node, hdr.dest_node, 0},
+                               payload ? payload->size() : hdr.payload_len);
   }
 
-  void message_forwarding_failed_cb(const io::basp::header&,
-                                    const std::vector<char>*) override {
-    // do nothing (yet)
+  void message_forwarding_failed_cb(const io::basp::header& hdr,
+                                    const std::vector<char>* payload) override {
+    count(hdr.source_node, hdr.dest_node, forwarding_failed,
+          payload ? payload->size() : hdr.payload_len);
   }
 
   void message_sending_failed_cb(const strong_actor_ptr&,
-                                 const strong_actor_ptr&, message_id,
-                                 const message&) override {
-    // do nothing (yet)
+                                 const strong_actor_ptr& dest, message_id,
+                                 const message& msg) override {
+    count(node_, dest ? dest->node() : invalid_node_id, sending_failed,
+          size_of(msg));
   }
 
   void actor_published_cb(const strong_actor_ptr& addr,
                           const std::set<std::string>&,
                           uint16_t port) override {
     transmit<new_actor_published>(node_, addr, port);
+    published_->push(addr);
   }
 
-  void new_remote_actor_cb(const strong_actor_ptr&) override {
-    // do nothing (yet)
+  void new_remote_actor_cb(const strong_actor_ptr& x) override {
+    if (x)
+      count(x->node(), node_, remote_actor, 0);
   }
 
   void new_connection_established_cb(const node_id& dest) override {
     transmit<new_route>(node_, dest, true);
+    peers_->push(dest);
   }
 
   void new_route_added_cb(const node_id&, const node_id& dest) override {
     transmit<new_route>(node_, dest, false);
   }
 
-  void invalid_message_received_cb(const node_id&, const strong_actor_ptr&,
-                                   actor_id, message_id,
-                                   const message&) override {
-    // do nothing (yet)
+  void invalid_message_received_cb(const node_id& source,
+                                   const strong_actor_ptr&, actor_id,
+                                   message_id, const message& msg) override {
+    count(source, node_, invalid_message, size_of(msg));
   }
 
 private:
-  scoped_actor self_;
-  nexus_type uplink_;
+  // checks whether `x` is the local pinger or ping responder
+  bool is_ping(const strong_actor_ptr& x) {
+    if (! x || x->node() != node_)
+      return false;
+    auto aid = x->id();
+    return aid == responder_id_ || aid == pinger_id_;
+  }
+
+  void count(const node_id& from, const node_id& to, route_event_kind kind,
+             uint64_t bytes) {
+    if (counters_)
+      counters_->events.add(route_key{from, to, kind}, bytes);
+  }
+
+  // selects the same requests and responses on all nodes by hashing the
+  // request ID and the requesting actor, i.e., both ends of a request
+  // report it regardless of their sample rates
+  bool span_selected(const strong_actor_ptr& from,
+                     const strong_actor_ptr& dest, message_id mid) {
+    if (span_rate_ == 0 || ! (mid.is_request() || mid.is_response()))
+      return false;
+    auto req = mid.integer_value() & trace_store::request_id_mask;
+    auto client = mid.is_response() ? id(dest) : id(from);
+    return (req * 31 + client) % span_rate_ == 0;
+  }
+
+  void trace(const node_id& source_node, const node_id& dest_node,
+             const strong_actor_ptr& from, const strong_actor_ptr& dest,
+             message_id mid, const message& msg, uint32_t size,
+             bool received) {
+    auto source_actor = id(from);
+    auto dest_actor = id(dest);
+    new_message x{source_node, dest_node, source_actor, dest_actor,
+                  mid.integer_value(), msg.type_token(), size, timestamp(),
+                  received, none};
+    // traces with content are rare and too large for the rings
+    if (capture(source_actor, dest_actor, msg)) {
+      x.msg = msg;
+      buf_->push(std::move(x));
+      return;
+    }
+    rings_->push(std::move(x));
+  }
+
+  // returns the size of `msg` in the payload of its BASP message; the
+  // callbacks for sent and received messages do not pass the BASP header
+  uint32_t payload_size(const message& msg) {
+    byte_counter counter;
+    stream_serializer<byte_counter&> sink{sys_, counter};
+    auto tmp = msg;
+    sink << tmp;
+    return static_cast<uint32_t>(counter.count());
+  }
+
+  // returns 0 if counting bytes is disabled
+  uint32_t size_of(const message& msg) {
+    return measure_sizes_ ? payload_size(msg) : 0;
+  }
+
+  bool capture(actor_id source_actor, actor_id dest_actor,
+               const message& msg) {
+    if (capture_actors_.empty() && capture_types_.empty())
+      return false;
+    auto match = [&] {
+      if (capture_actors_.count(source_actor) > 0
+          || capture_actors_.count(dest_actor) > 0)
+        return true;
+      if (capture_types_.empty() || msg.empty())
+        return false;
+      auto& types = sys_.types();
+      return capture_types_.count(types.portable_name(msg.type(0))) > 0;
+    };
+    return match() && captured_++ % capture_rate_ == 0;
+  }
+
+  actor_system& sys_;
   node_id node_;
+  std::shared_ptr<event_buffer> buf_;
+  std::shared_ptr<trace_rings> rings_;
+  std::shared_ptr<shared_queue<node_id>> peers_;
+  std::shared_ptr<shared_queue<strong_actor_ptr>> published_;
+  std::set<actor_id> capture_actors_;
+  std::set<std::string> capture_types_;
+  size_t capture_rate_;
+  size_t span_rate_;
+  std::atomic<size_t> captured_;
+  sampler sampler_;
+  bool trace_messages_;
+  bool measure_sizes_;
+  traffic_counters_ptr counters_;
+  std::atomic<actor_id> responder_id_;
+  std::atomic<actor_id> pinger_id_;
 };
 
 } // namespace <anonymous>
 
 probe::probe(actor_system& sys)
     : system_(sys),
-      uplink_(unsafe_actor_handle_init) {
+      connector_(unsafe_actor_handle_init),
+      flusher_(unsafe_actor_handle_init),
+      collector_(unsafe_actor_handle_init),
+      ping_responder_(unsafe_actor_handle_init),
+      pinger_(unsafe_actor_handle_init),
+      profiler_(unsafe_actor_handle_init) {
   // nop
 }
 
 void probe::start() {
   CAF_LOG_TRACE("");
-  try {
-    uplink_ = system_.middleman().typed_remote_actor<nexus_type>(nexus_host_,
-                                                                 nexus_port_);
-  }
-  catch (std::exception& e) {
-    CAF_LOG_ERROR("could not connect to Nexus:"
-                  << CAF_ARG(nexus_host_) << CAF_ARG(nexus_port_)
-                  << CAF_ARG(e.what()));
-    return;
-  }
   auto is_fwd_hook = [](const io::hook_uptr& ptr) {
     return typeid(ptr.get()) == typeid(io::hook*);
   };
   auto& hooks = system_.middleman().hooks();
   auto e = hooks.end();
   auto i = std::find_if(hooks.begin(), e, is_fwd_hook);
-  if (i == e)
+  if (i == e) {
     CAF_LOG_ERROR("unable to find fwd_hook!");
-  else
-    static_cast<fwd_hook*>(i->get())->register_at_nexus(uplink_);
+    return;
+  }
+  auto hook = static_cast<fwd_hook*>(i->get());
+  buf_ = hook->buffer();
+  rings_ = hook->rings();
+  auto& st = get_settings(system_.config());
+  connector_ = system_.spawn<hidden>(connector, buf_, nexus_host_,
+                                     nexus_port_, st);
+  flusher_ = system_.spawn<hidden>(flusher, buf_, rings_,
+                                   milliseconds(st.flush_interval),
+                                   hook->counters(),
+                                   milliseconds(st.traffic_interval));
+  if (st.stats_interval > 0 || st.thread_stats_interval > 0)
+    collector_ = system_.spawn<hidden>(collector, buf_,
+                                       milliseconds(st.stats_interval),
+                                       milliseconds(st.thread_stats_interval));
+  ping_responder_ = system_.spawn<hidden>(ping_responder);
+  system_.registry().put(ping_responder_key,
+                         actor_cast<strong_actor_ptr>(ping_responder_));
+  if (st.ping_interval > 0)
+    pinger_ = system_.spawn<detached + hidden>(pinger, buf_, hook->peers(),
+                                               st);
+  hook->ignore_pings(ping_responder_.id(),
+                     pinger_.unsafe() ? invalid_actor_id : pinger_.id());
+  if (st.profile_interval > 0)
+    profiler_ = system_.spawn<hidden>(profiler, buf_, hook->published(), st);
 }
 
 void probe::stop() {
-  // nop
+  if (buf_) {
+    drain(*rings_, *buf_);
+    buf_->flush();
+  }
+  if (! connector_.unsafe())
+    anon_send_exit(connector_, exit_reason::user_shutdown);
+  if (! flusher_.unsafe())
+    anon_send_exit(flusher_, exit_reason::user_shutdown);
+  if (! collector_.unsafe())
+    anon_send_exit(collector_, exit_reason::user_shutdown);
+  if (! ping_responder_.unsafe()) {
+    system_.registry().erase(ping_responder_key);
+    anon_send_exit(ping_responder_, exit_reason::user_shutdown);
+  }
+  if (! pinger_.unsafe())
+    anon_send_exit(pinger_, exit_reason::user_shutdown);
+  if (! profiler_.unsafe())
+    anon_send_exit(profiler_, exit_reason::user_shutdown);
 }
 
 void probe::init(actor_system_config& cfg) {
@@ -203,7 +971,7 @@ actor_system::module::id_t probe::id() const {
 }
 
 bool probe::connected() {
-  return ! uplink_.unsafe();
+  return buf_ && buf_->connected();
 }
 
 void* probe::subtype_ptr() {
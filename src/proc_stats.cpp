@@ -0,0 +1,273 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2015                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#include "caf/riac/proc_stats.hpp"
+
+#include "caf/config.hpp"
+
+#ifdef CAF_LINUX
+#include <fcntl.h>
+#include <dirent.h>
+#include <unistd.h>
+#endif
+
+#include <string>
+#include <cstdlib>
+#include <algorithm>
+#include <cstring>
+
+namespace caf {
+namespace riac {
+
+namespace {
+
+constexpr size_t initial_buffer_size = 4096;
+
+bool is_digit(char c) {
+  return c >= '0' && c <= '9';
+}
+
+// parses the next unsigned integer in [pos, last), skipping any leading
+// non-digit characters
+bool parse_uint(const char*& pos, const char* last, uint64_t& x) {
+  while (pos != last && ! is_digit(*pos))
+    ++pos;
+  if (pos == last)
+    return false;
+  x = 0;
+  while (pos != last && is_digit(*pos))
+    x = x * 10 + static_cast<uint64_t>(*pos++ - '0');
+  return true;
+}
+
+// parses the value of the line starting with `key` in [first, last)
+bool parse_field(const char* first, const char* last, const char* key,
+                 uint64_t& x) {
+  auto n = strlen(key);
+  auto pos = first;
+  while (static_cast<size_t>(last - pos) > n) {
+    if (strncmp(pos, key, n) == 0) {
+      pos += n;
+      return parse_uint(pos, last, x);
+    }
+    pos = static_cast<const char*>(memchr(pos, '\n', last - pos));
+    if (pos == nullptr)
+      return false;
+    ++pos;
+  }
+  return false;
+}
+
+} // namespace <anonymous>
+
+#ifdef CAF_LINUX
+
+proc_stats::proc_stats()
+    : meminfo_(open("/proc/meminfo", O_RDONLY | O_CLOEXEC)),
+      stat_(open("/proc/stat", O_RDONLY | O_CLOEXEC)),
+      loadavg_(open("/proc/loadavg", O_RDONLY | O_CLOEXEC)),
+      buf_(initial_buffer_size),
+      prev_total_(0),
+      prev_idle_(0) {
+  // nop
+}
+
+proc_stats::~proc_stats() {
+  for (auto fd : {meminfo_, stat_, loadavg_})
+    if (fd >= 0)
+      close(fd);
+}
+
+size_t proc_stats::read_file(int fd) {
+  if (fd < 0)
+    return 0;
+  for (;;) {
+    auto res = pread(fd, buf_.data(), buf_.size(), 0);
+    if (res <= 0)
+      return 0;
+    auto n = static_cast<size_t>(res);
+    if (n < buf_.size())
+      return n;
+    // the buffer was too small, retry with a bigger one
+    buf_.resize(buf_.size() * 2);
+  }
+}
+
+size_t proc_stats::read_file(const char* path) {
+  auto fd = open(path, O_RDONLY | O_CLOEXEC);
+  if (fd < 0)
+    return 0;
+  auto n = read_file(fd);
+  close(fd);
+  return n;
+}
+
+bool proc_stats::read(thread_load& x) {
+  auto dir = opendir("/proc/self/task");
+  if (dir == nullptr)
+    return false;
+  using namespace std::chrono;
+  auto now = steady_clock::now();
+  auto dt = duration_cast<milliseconds>(now - prev_time_).count();
+  prev_time_ = now;
+  static const auto ticks_per_sec = sysconf(_SC_CLK_TCK);
+  std::unordered_map<uint32_t, thread_sample> samples;
+  x.threads.clear();
+  std::string prefix = "/proc/self/task/";
+  while (auto entry = readdir(dir)) {
+    if (! is_digit(entry->d_name[0]))
+      continue;
+    auto tid = static_cast<uint32_t>(strtoul(entry->d_name, nullptr, 10));
+    auto path = prefix + entry->d_name;
+    // the format is "tid (comm) state ppid ...", whereas comm can contain
+    // spaces and parentheses
+    auto n = read_file((path + "/stat").c_str());
+    if (n == 0)
+      continue;
+    const char* first = buf_.data();
+    const char* last = first + n;
+    auto lp = static_cast<const char*>(memchr(first, '(', n));
+    auto rp = last;
+    while (rp != first && *(rp - 1) != ')')
+      --rp;
+    if (lp == nullptr || rp == first || rp - first + 2 > last - first)
+      continue;
+    thread_stats ts;
+    ts.tid = tid;
+    ts.name.assign(lp + 1, rp - 1);
+    // skip the state and parse the fields starting at ppid (field 4),
+    // i.e., utime (14) and stime (15) are at index 10 and 11 and
+    // processor (39) is at index 35
+    const char* pos = rp + 2;
+    uint64_t fields[36];
+    size_t num_fields = 0;
+    while (num_fields < 36 && parse_uint(pos, last, fields[num_fields]))
+      ++num_fields;
+    if (num_fields < 36)
+      continue;
+    thread_sample sample{fields[10] + fields[11], 0};
+    ts.processor = static_cast<uint32_t>(fields[35]);
+    // "cpu time, run queue wait time, timeslices" in nanoseconds; only
+    // available if the kernel collects scheduler statistics
+    n = read_file((path + "/schedstat").c_str());
+    pos = buf_.data();
+    uint64_t cpu_time;
+    if (n > 0 && parse_uint(pos, buf_.data() + n, cpu_time))
+      parse_uint(pos, buf_.data() + n, sample.run_delay);
+    ts.cpu_load = 0;
+    ts.run_delay = 0;
+    auto i = prev_threads_.find(tid);
+    if (i != prev_threads_.end() && dt > 0 && ticks_per_sec > 0) {
+      auto dticks = sample.ticks - i->second.ticks;
+      auto load = dticks * 1000 * 100
+                  / (static_cast<uint64_t>(dt) * ticks_per_sec);
+      ts.cpu_load = static_cast<uint8_t>(std::min<uint64_t>(load, 100));
+      ts.run_delay = (sample.run_delay - i->second.run_delay) / 1000;
+    }
+    samples.emplace(tid, sample);
+    x.threads.push_back(std::move(ts));
+  }
+  closedir(dir);
+  prev_threads_.swap(samples);
+  return ! x.threads.empty();
+}
+
+#else // CAF_LINUX
+
+proc_stats::proc_stats()
+    : meminfo_(-1),
+      stat_(-1),
+      loadavg_(-1),
+      prev_total_(0),
+      prev_idle_(0) {
+  // nop
+}
+
+proc_stats::~proc_stats() {
+  // nop
+}
+
+size_t proc_stats::read_file(int) {
+  return 0;
+}
+
+size_t proc_stats::read_file(const char*) {
+  return 0;
+}
+
+bool proc_stats::read(thread_load&) {
+  return false;
+}
+
+#endif // CAF_LINUX
+
+bool proc_stats::read(ram_usage& x) {
+  auto n = read_file(meminfo_);
+  if (n == 0)
+    return false;
+  auto first = buf_.data();
+  auto last = first + n;
+  uint64_t total;
+  uint64_t available;
+  if (! parse_field(first, last, "MemTotal:", total)
+      || ! parse_field(first, last, "MemAvailable:", available))
+    return false;
+  // values are in kB
+  x.in_use = (total - available) * 1024;
+  x.available = available * 1024;
+  return true;
+}
+
+bool proc_stats::read(work_load& x) {
+  // the first line of /proc/stat contains the accumulated CPU times:
+  // user nice system idle iowait irq softirq steal ...
+  auto n = read_file(stat_);
+  if (n == 0 || strncmp(buf_.data(), "cpu ", 4) != 0)
+    return false;
+  const char* pos = buf_.data() + 4;
+  auto eol = static_cast<const char*>(memchr(pos, '\n', n - 4));
+  auto last = eol != nullptr ? eol : buf_.data() + n;
+  uint64_t total = 0;
+  uint64_t idle = 0;
+  uint64_t value;
+  // guest times are already included in user and nice
+  for (size_t i = 0; i < 8 && parse_uint(pos, last, value); ++i) {
+    total += value;
+    if (i == 3 || i == 4) // idle + iowait
+      idle += value;
+  }
+  auto dtotal = total - prev_total_;
+  auto didle = idle - prev_idle_;
+  prev_total_ = total;
+  prev_idle_ = idle;
+  x.cpu_load = dtotal > 0
+               ? static_cast<uint8_t>((dtotal - didle) * 100 / dtotal)
+               : 0;
+  // /proc/loadavg has the format "0.10 0.20 0.30 running/total last_pid"
+  n = read_file(loadavg_);
+  if (n == 0)
+    return false;
+  pos = static_cast<const char*>(memchr(buf_.data(), '/', n));
+  if (pos == nullptr)
+    return false;
+  return parse_uint(pos, buf_.data() + n, x.num_processes);
+}
+
+} // namespace riac
+} // namespace caf
@@ -0,0 +1,321 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2015                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#include "caf/riac/regional_nexus.hpp"
+
+#include <chrono>
+#include <iostream>
+#include <iterator>
+#include <algorithm>
+
+#include "caf/actor_ostream.hpp"
+
+#include "caf/riac/config.hpp"
+
+using std::endl;
+
+namespace caf {
+namespace riac {
+
+regional_nexus::regional_nexus(actor_config& cfg, bool silent,
+                               nexus_type upstream)
+    : regional_nexus_type::base(cfg),
+      silent_(silent),
+      upstream_(std::move(upstream)),
+      interval_(std::max<size_t>(1, get_settings(home_system().config())
+                                    .region_interval)),
+      compact_(get_settings(home_system().config()).compact_wire),
+      max_messages_(get_settings(home_system().config())
+                    .region_max_messages),
+      num_messages_(0) {
+  set_down_handler([=](down_msg& dm) {
+    auto ptr = actor_cast<strong_actor_ptr>(dm.source);
+    if (ptr == actor_cast<strong_actor_ptr>(upstream_)) {
+      if (! silent_)
+        aout(this) << "upstream nexus down, quit" << endl;
+      quit(dm.reason);
+      return;
+    }
+    auto i = probes_.find(ptr);
+    if (i == probes_.end())
+      return;
+    for (auto& nid : i->second) {
+      remove(ptr, nid);
+      send(upstream_, node_disconnected{nid});
+    }
+    probes_.erase(i);
+  });
+}
+
+void regional_nexus::remove(const strong_actor_ptr& src,
+                            const node_id& nid) {
+  pending_.erase(nid);
+  // a new encoder starts a new session if the node comes back
+  encoders_.erase(nid);
+  decoders_.erase(std::make_pair(src, nid));
+}
+
+void regional_nexus::add(const ram_usage& x) {
+  pending_[x.source_node].ram = x;
+}
+
+void regional_nexus::add(const work_load& x) {
+  pending_[x.source_node].load = x;
+}
+
+void regional_nexus::add(const new_route& x) {
+  if (! x.is_direct)
+    return;
+  auto& st = pending_[x.source_node];
+  // re-adding a route we have lost since the last tick is a no-op
+  if (st.lost_routes.erase(x.dest) == 0)
+    st.added_routes.insert(x.dest);
+}
+
+void regional_nexus::add(const route_lost& x) {
+  auto& st = pending_[x.source_node];
+  // losing a route we have added since the last tick is a no-op
+  if (st.added_routes.erase(x.dest) == 0)
+    st.lost_routes.insert(x.dest);
+}
+
+void regional_nexus::add(const new_message& x) {
+  auto& st = pending_[x.source_node];
+  // traces grow with the traffic in the region rather than its size
+  if (max_messages_ > 0 && num_messages_ >= max_messages_) {
+    ++st.dropped;
+    return;
+  }
+  ++num_messages_;
+  st.messages.push_back(x);
+}
+
+void regional_nexus::add(const new_actor_published& x) {
+  pending_[x.source_node].published_actors.push_back(x);
+}
+
+void regional_nexus::add(const traffic_delta& x) {
+  auto& st = pending_[x.source_node];
+  accumulate(st.node_traffic_out, st.actor_traffic_out, x);
+  accumulate(st.forwarded, st.route_event_counts, x);
+  st.traffic_dropped += x.dropped;
+}
+
+void regional_nexus::add(const route_stats& x) {
+  pending_[x.source_node].latencies[x.dest] = x;
+}
+
+void regional_nexus::add(const actor_hotspots& x) {
+  pending_[x.source_node].hotspots = x;
+}
+
+void regional_nexus::add(const thread_load& x) {
+  pending_[x.source_node].threads = x;
+}
+
+void regional_nexus::add(const event_batch& x) {
+  pending_[x.source_node].dropped += x.dropped;
+  for (auto& y : x.ram)
+    add(y);
+  for (auto& y : x.load)
+    add(y);
+  for (auto& y : x.routes)
+    add(y);
+  for (auto& y : x.lost_routes)
+    add(y);
+  for (auto& y : x.messages)
+    add(y);
+  for (auto& y : x.published_actors)
+    add(y);
+  for (auto& y : x.traffic)
+    add(y);
+  for (auto& y : x.latencies)
+    add(y);
+  for (auto& y : x.hotspots)
+    add(y);
+  for (auto& y : x.threads)
+    add(y);
+}
+
+void regional_nexus::add(const compact_batch& x) {
+  event_batch batch;
+  auto key = std::make_pair(current_element_->sender, x.source_node);
+  if (decoders_[key].decode(x, batch))
+    add(batch);
+}
+
+void regional_nexus::flush() {
+  num_messages_ = 0;
+  if (pending_.empty())
+    return;
+  region_summary summary;
+  for (auto& kvp : pending_) {
+    auto& nid = kvp.first;
+    auto& st = kvp.second;
+    event_batch batch;
+    batch.source_node = nid;
+    batch.dropped = st.dropped;
+    if (st.ram)
+      batch.ram.push_back(std::move(*st.ram));
+    if (st.load)
+      batch.load.push_back(std::move(*st.load));
+    for (auto& dest : st.added_routes)
+      batch.routes.push_back(new_route{nid, dest, true});
+    for (auto& dest : st.lost_routes)
+      batch.lost_routes.push_back(route_lost{nid, dest});
+    std::move(st.messages.begin(), st.messages.end(),
+              std::back_inserter(batch.messages));
+    std::move(st.published_actors.begin(), st.published_actors.end(),
+              std::back_inserter(batch.published_actors));
+    for (auto& x : st.latencies)
+      batch.latencies.push_back(x.second);
+    if (st.hotspots)
+      batch.hotspots.push_back(std::move(*st.hotspots));
+    if (st.threads)
+      batch.threads.push_back(std::move(*st.threads));
+    traffic_delta td;
+    td.source_node = nid;
+    td.dropped = st.traffic_dropped;
+    for (auto& x : st.node_traffic_out)
+      td.nodes.push_back(x.second);
+    for (auto& x : st.actor_traffic_out)
+      td.actors.push_back(x.second);
+    for (auto& x : st.forwarded)
+      td.forwarded.push_back(x.second);
+    for (auto& x : st.route_event_counts)
+      td.events.push_back(x.second);
+    if (! td.nodes.empty() || ! td.actors.empty() || ! td.forwarded.empty()
+        || ! td.events.empty() || td.dropped > 0)
+      batch.traffic.push_back(std::move(td));
+    append(summary, batch);
+  }
+  pending_.clear();
+  if (! summary.compact.empty() || ! summary.batches.empty())
+    send(upstream_, std::move(summary));
+}
+
+void regional_nexus::append(region_summary& out, event_batch& batch) {
+  if (batch.dropped == 0 && batch.ram.empty() && batch.load.empty()
+      && batch.routes.empty() && batch.lost_routes.empty()
+      && batch.messages.empty() && batch.published_actors.empty()
+      && batch.traffic.empty() && batch.latencies.empty()
+      && batch.hotspots.empty() && batch.threads.empty())
+    return;
+  if (! compact_) {
+    out.batches.push_back(std::move(batch));
+    return;
+  }
+  out.compact.push_back(encoders_[batch.source_node].encode(batch));
+  // only events without compact representation remain in `batch`
+  if (! batch.messages.empty() || ! batch.published_actors.empty()
+      || ! batch.latencies.empty() || ! batch.hotspots.empty()
+      || ! batch.threads.empty())
+    out.batches.push_back(std::move(batch));
+}
+
+regional_nexus::behavior_type regional_nexus::make_behavior() {
+  monitor(upstream_);
+  delayed_send(this, std::chrono::milliseconds(interval_), tick_atom::value);
+  return {
+    [=](const node_info& ni) {
+      auto ls = current_element_->sender;
+      if (ls && probes_[ls].insert(ni.source_node).second)
+        monitor(ls);
+      send(upstream_, ni);
+    },
+    [=](const node_disconnected& nd) {
+      remove(current_element_->sender, nd.source_node);
+      send(upstream_, nd);
+    },
+    [=](const ram_usage& x) {
+      add(x);
+    },
+    [=](const work_load& x) {
+      add(x);
+    },
+    [=](const new_route& x) {
+      add(x);
+    },
+    [=](const route_lost& x) {
+      add(x);
+    },
+    [=](const new_message& x) {
+      add(x);
+    },
+    [=](const new_actor_published& x) {
+      add(x);
+    },
+    [=](const traffic_delta& x) {
+      add(x);
+    },
+    [=](const route_stats& x) {
+      add(x);
+    },
+    [=](const actor_hotspots& x) {
+      add(x);
+    },
+    [=](const thread_load& x) {
+      add(x);
+    },
+    [=](const event_batch& batch) {
+      add(batch);
+    },
+    [=](const compact_batch& x) {
+      add(x);
+    },
+    [=](const region_summary& x) {
+      for (auto& y : x.compact)
+        add(y);
+      for (auto& y : x.batches)
+        add(y);
+    },
+    [=](add_atom atm, actor& x) {
+      delegate(upstream_, atm, std::move(x));
+    },
+    [=](add_atom atm, actor& x, uint64_t since) {
+      delegate(upstream_, atm, std::move(x), since);
+    },
+    [=](add_atom atm, actor& x, subscription& sub) {
+      delegate(upstream_, atm, std::move(x), std::move(sub));
+    },
+    [=](add_atom atm, listener_type& x) {
+      delegate(upstream_, atm, std::move(x));
+    },
+    [=](add_atom atm, listener_type& x, uint64_t since) {
+      delegate(upstream_, atm, std::move(x), since);
+    },
+    [=](add_atom atm, listener_type& x, subscription& sub) {
+      delegate(upstream_, atm, std::move(x), std::move(sub));
+    },
+    [=](credit_atom atm, uint32_t n) {
+      delegate(upstream_, atm, n);
+    },
+    [=](credit_atom atm, listener_type& x, uint32_t n) {
+      delegate(upstream_, atm, std::move(x), n);
+    },
+    [=](tick_atom) {
+      flush();
+      delayed_send(this, std::chrono::milliseconds(interval_),
+                   tick_atom::value);
+    }
+  };
+}
+
+} // namespace riac
+} // namespace caf
@@ -0,0 +1,97 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2015                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#include "caf/riac/sampler.hpp"
+
+#include <tuple>
+#include <cstdlib>
+#include <algorithm>
+
+namespace caf {
+namespace riac {
+
+sampler::sampler(size_t rate, size_t max_rate,
+                 const std::map<actor_id, size_t>& rates)
+    : global_(rate),
+      dropped_(0),
+      max_rate_(static_cast<double>(max_rate)),
+      tokens_(static_cast<double>(max_rate)),
+      last_refill_(clock_type::now()) {
+  for (auto& kvp : rates)
+    per_actor_.emplace(std::piecewise_construct,
+                       std::forward_as_tuple(kvp.first),
+                       std::forward_as_tuple(kvp.second));
+}
+
+sampler::sampler(const settings& cfg)
+    : sampler(cfg.sample_rate, cfg.max_rate, parse_rates(cfg.sample_rates)) {
+  // nop
+}
+
+bool sampler::select(actor_id dest, clock_type::time_point now) {
+  auto i = per_actor_.find(dest);
+  auto& c = i != per_actor_.end() ? i->second : global_;
+  if (c.count++ % c.rate != 0 || ! take_token(now)) {
+    ++dropped_;
+    return false;
+  }
+  return true;
+}
+
+size_t sampler::dropped() const {
+  return dropped_;
+}
+
+std::map<actor_id, size_t> sampler::parse_rates(const std::string& str) {
+  std::map<actor_id, size_t> result;
+  auto first = str.c_str();
+  char* pos;
+  for (;;) {
+    auto aid = strtoull(first, &pos, 10);
+    if (pos == first || *pos != '=')
+      return result;
+    first = pos + 1;
+    auto rate = strtoull(first, &pos, 10);
+    if (pos == first)
+      return result;
+    result.emplace(static_cast<actor_id>(aid), static_cast<size_t>(rate));
+    if (*pos != ',')
+      return result;
+    first = pos + 1;
+  }
+}
+
+bool sampler::take_token(clock_type::time_point now) {
+  if (max_rate_ <= 0)
+    return true;
+  std::unique_lock<std::mutex> guard{mtx_};
+  if (now > last_refill_) {
+    using fsec = std::chrono::duration<double>;
+    auto elapsed = std::chrono::duration_cast<fsec>(now - last_refill_);
+    tokens_ = std::min(max_rate_, tokens_ + elapsed.count() * max_rate_);
+    last_refill_ = now;
+  }
+  if (tokens_ < 1.)
+    return false;
+  tokens_ -= 1.;
+  return true;
+}
+
+} // namespace riac
+} // namespace caf
@@ -0,0 +1,171 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2015                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#include "caf/riac/sharded_nexus.hpp"
+
+#include <memory>
+#include <algorithm>
+#include <functional>
+
+#include "caf/riac/nexus.hpp"
+
+namespace caf {
+namespace riac {
+
+sharded_nexus::sharded_nexus(actor_config& cfg, bool silent,
+                             size_t num_shards)
+    : nexus_type::base(cfg),
+      silent_(silent),
+      num_shards_(num_shards > 0 ? num_shards : 1),
+      credits_(num_shards_) {
+  set_down_handler([=](down_msg& dm) {
+    auto ptr = actor_cast<strong_actor_ptr>(dm.source);
+    if (ptr)
+      credits_.erase(actor_cast<listener_type>(std::move(ptr)));
+  });
+}
+
+size_t sharded_nexus::index(const node_id& nid) const {
+  return std::hash<node_id>{}(nid) % shards_.size();
+}
+
+void sharded_nexus::split(region_summary& x) {
+  std::vector<region_summary> parts(shards_.size());
+  for (auto& y : x.compact)
+    parts[index(y.source_node)].compact.push_back(std::move(y));
+  for (auto& y : x.batches)
+    parts[index(y.source_node)].batches.push_back(std::move(y));
+  auto src = current_sender();
+  for (size_t i = 0; i < parts.size(); ++i) {
+    auto n = parts[i].compact.size() + parts[i].batches.size();
+    if (n == 0)
+      continue;
+    credits_.count(i, n);
+    shards_[i]->enqueue(src, message_id::make(),
+                        make_message(std::move(parts[i])), context());
+  }
+}
+
+void sharded_nexus::add(listener_type hdl, subscription sub) {
+  // reset the listener once, shards only append to its state
+  send(hdl, state_delta{0, 0, true, false, probe_data_map{}, {}});
+  sub.since = 0;
+  // drops the credit rotation of the listener once it terminates
+  monitor(hdl);
+  std::vector<uint32_t> shares;
+  if (sub.credit > 0)
+    shares = credits_.split(hdl, sub.credit);
+  auto pending = std::make_shared<size_t>(shards_.size());
+  for (size_t i = 0; i < shards_.size(); ++i) {
+    if (! shares.empty())
+      sub.credit = std::max<uint32_t>(1, shares[i]);
+    request(shards_[i], infinite, add_atom::value, hdl, sub).then([=] {
+      // all shards have sent their state once the last one replies;
+      // version 0 makes the listener request a full transfer next time
+      if (--*pending == 0)
+        send(hdl, state_delta{0, 0, false, true, probe_data_map{}, {}});
+    });
+  }
+}
+
+void sharded_nexus::grant(const listener_type& hdl, uint32_t n) {
+  auto shares = credits_.split(hdl, n);
+  for (size_t i = 0; i < shards_.size(); ++i)
+    if (shares[i] > 0)
+      send(shards_[i], credit_atom::value, hdl, shares[i]);
+}
+
+sharded_nexus::behavior_type sharded_nexus::make_behavior() {
+  for (size_t i = 0; i < num_shards_; ++i)
+    shards_.push_back(spawn<nexus, linked>(silent_, true));
+  return {
+    [=](node_info& x) {
+      forward(x);
+    },
+    [=](node_disconnected& x) {
+      forward(x);
+    },
+    [=](ram_usage& x) {
+      forward(x);
+    },
+    [=](work_load& x) {
+      forward(x);
+    },
+    [=](new_route& x) {
+      forward(x);
+    },
+    [=](route_lost& x) {
+      forward(x);
+    },
+    [=](new_message& x) {
+      forward(x);
+    },
+    [=](new_actor_published& x) {
+      forward(x);
+    },
+    [=](traffic_delta& x) {
+      forward(x);
+    },
+    [=](route_stats& x) {
+      forward(x);
+    },
+    [=](actor_hotspots& x) {
+      forward(x);
+    },
+    [=](thread_load& x) {
+      forward(x);
+    },
+    [=](event_batch& x) {
+      forward(x);
+    },
+    [=](compact_batch& x) {
+      forward(x);
+    },
+    [=](region_summary& x) {
+      split(x);
+    },
+    [=](add_atom, actor& x) {
+      add(actor_cast<listener_type>(std::move(x)), subscription{});
+    },
+    [=](add_atom, actor& x, uint64_t) {
+      add(actor_cast<listener_type>(std::move(x)), subscription{});
+    },
+    [=](add_atom, actor& x, subscription& sub) {
+      add(actor_cast<listener_type>(std::move(x)), std::move(sub));
+    },
+    [=](add_atom, listener_type& x) {
+      add(std::move(x), subscription{});
+    },
+    [=](add_atom, listener_type& x, uint64_t) {
+      add(std::move(x), subscription{});
+    },
+    [=](add_atom, listener_type& x, subscription& sub) {
+      add(std::move(x), std::move(sub));
+    },
+    [=](credit_atom, uint32_t n) {
+      grant(actor_cast<listener_type>(current_sender()), n);
+    },
+    [=](credit_atom, const listener_type& x, uint32_t n) {
+      grant(x, n);
+    }
+  };
+}
+
+} // namespace riac
+} // namespace caf
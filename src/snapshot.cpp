@@ -0,0 +1,186 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2015                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#include "caf/riac/snapshot.hpp"
+
+#include "caf/config.hpp"
+
+#ifndef CAF_WINDOWS
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+#include <vector>
+#include <cerrno>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+
+#include "caf/actor_system.hpp"
+#include "caf/event_based_actor.hpp"
+#include "caf/binary_serializer.hpp"
+#include "caf/binary_deserializer.hpp"
+
+namespace caf {
+namespace riac {
+
+namespace {
+
+// "RIAC" in ASCII
+constexpr uint32_t snapshot_magic = 0x52494143;
+
+// incremented whenever the layout of a snapshot changes
+constexpr uint32_t snapshot_format = 2;
+
+bool restore(actor_system& sys, const char* buf, size_t size,
+             uint64_t& version, probe_data_map& data) {
+  try {
+    binary_deserializer bd{sys, buf, size};
+    uint32_t magic;
+    uint32_t format;
+    bd >> magic >> format;
+    if (magic != snapshot_magic || format != snapshot_format)
+      return false;
+    uint64_t count;
+    bd >> version >> count;
+    probe_data_map result;
+    for (uint64_t i = 0; i < count; ++i) {
+      node_id nid;
+      bd >> nid;
+      auto& x = result[nid];
+      x.version = 0;
+      bd >> x.node >> x.ram >> x.load >> x.direct_routes
+         >> x.node_traffic_out >> x.actor_traffic_out >> x.forwarded
+         >> x.route_event_counts;
+    }
+    data = std::move(result);
+    return true;
+  }
+  catch (std::exception&) {
+    return false;
+  }
+}
+
+} // namespace <anonymous>
+
+std::vector<char> serialize_snapshot(actor_system& sys, uint64_t version,
+                                     const probe_data_map& data) {
+  std::vector<char> buf;
+  binary_serializer bs{sys, buf};
+  auto magic = snapshot_magic;
+  auto format = snapshot_format;
+  uint64_t count = data.size();
+  bs << magic << format << version << count;
+  // serializers take mutable references
+  for (auto& kvp : data) {
+    auto nid = kvp.first;
+    auto& x = const_cast<probe_data&>(kvp.second);
+    bs << nid << x.node << x.ram << x.load << x.direct_routes
+       << x.node_traffic_out << x.actor_traffic_out << x.forwarded
+       << x.route_event_counts;
+  }
+  return buf;
+}
+
+behavior snapshot_writer(event_based_actor*, std::string path) {
+  return {
+    [=](const std::vector<char>& buf) {
+      return write_snapshot(path, buf);
+    }
+  };
+}
+
+#ifndef CAF_WINDOWS
+
+bool write_snapshot(const std::string& path, const std::vector<char>& buf) {
+  auto tmp = path + ".tmp";
+  auto fd = open(tmp.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+  if (fd < 0)
+    return false;
+  auto pos = buf.data();
+  auto left = buf.size();
+  while (left > 0) {
+    auto n = write(fd, pos, left);
+    if (n < 0) {
+      if (errno == EINTR)
+        continue;
+      close(fd);
+      return false;
+    }
+    pos += n;
+    left -= static_cast<size_t>(n);
+  }
+  // a crash after the rename must not leave an empty or partial file behind
+  auto synced = fsync(fd) == 0;
+  if (close(fd) != 0 || ! synced)
+    return false;
+  return std::rename(tmp.c_str(), path.c_str()) == 0;
+}
+
+bool read_snapshot(actor_system& sys, const std::string& path,
+                   uint64_t& version, probe_data_map& data) {
+  auto fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd < 0)
+    return false;
+  struct stat st;
+  if (fstat(fd, &st) != 0 || st.st_size == 0) {
+    close(fd);
+    return false;
+  }
+  auto size = static_cast<size_t>(st.st_size);
+  auto ptr = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (ptr == MAP_FAILED)
+    return false;
+  auto result = restore(sys, static_cast<const char*>(ptr), size,
+                        version, data);
+  munmap(ptr, size);
+  return result;
+}
+
+#else // CAF_WINDOWS
+
+bool write_snapshot(const std::string& path, const std::vector<char>& buf) {
+  auto tmp = path + ".tmp";
+  {
+    std::ofstream out{tmp, std::ios::binary | std::ios::trunc};
+    if (! out.write(buf.data(), static_cast<std::streamsize>(buf.size()))
+        || ! out.flush())
+      return false;
+  }
+  return std::rename(tmp.c_str(), path.c_str()) == 0;
+}
+
+bool read_snapshot(actor_system& sys, const std::string& path,
+                   uint64_t& version, probe_data_map& data) {
+  std::ifstream in{path, std::ios::binary};
+  if (! in)
+    return false;
+  std::vector<char> buf{std::istreambuf_iterator<char>{in},
+                        std::istreambuf_iterator<char>{}};
+  return restore(sys, buf.data(), buf.size(), version, data);
+}
+
+#endif // CAF_WINDOWS
+
+} // namespace riac
+} // namespace caf
@@ -0,0 +1,319 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2015                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#include "caf/riac/state_store.hpp"
+
+#include <tuple>
+#include <chrono>
+#include <utility>
+#include <algorithm>
+
+namespace caf {
+namespace riac {
+
+state_store::node_state::node_state(size_t history_minutes,
+                                    size_t history_hours)
+    : cpu_load(600, 600, history_minutes, history_hours),
+      ram_in_use(600, 600, history_minutes, history_hours) {
+  // nop
+}
+
+state_store::state_store(size_t history_minutes, size_t history_hours)
+    : history_minutes_(history_minutes),
+      history_hours_(history_hours) {
+  // nop
+}
+
+void state_store::update(const node_info& x) {
+  set_node(x.source_node, get(x.source_node), x);
+}
+
+void state_store::update(const ram_usage& x, uint64_t timestamp) {
+  auto& st = get(x.source_node);
+  st.ram = x;
+  st.ram_in_use.add(timestamp, static_cast<double>(x.in_use));
+}
+
+void state_store::update(const work_load& x, uint64_t timestamp) {
+  auto& st = get(x.source_node);
+  st.load = x;
+  st.cpu_load.add(timestamp, static_cast<double>(x.cpu_load));
+}
+
+void state_store::update(const new_route& x) {
+  if (! x.is_direct)
+    return;
+  auto& routes = get(x.source_node).routes;
+  auto i = std::lower_bound(routes.begin(), routes.end(), x.dest);
+  if (i == routes.end() || *i != x.dest)
+    routes.insert(i, x.dest);
+}
+
+void state_store::update(const route_lost& x) {
+  auto i = nodes_.find(x.source_node);
+  if (i == nodes_.end())
+    return;
+  auto& routes = i->second.routes;
+  auto j = std::lower_bound(routes.begin(), routes.end(), x.dest);
+  if (j != routes.end() && *j == x.dest)
+    routes.erase(j);
+  i->second.latencies.erase(x.dest);
+}
+
+void state_store::update(const route_stats& x) {
+  get(x.source_node).latencies[x.dest] = x;
+}
+
+void state_store::update(const thread_load& x) {
+  get(x.source_node).threads = x;
+}
+
+void state_store::update(const actor_hotspots& x) {
+  set_hot_actors(x.source_node, get(x.source_node), x.actors);
+}
+
+void state_store::update(const new_actor_published& x) {
+  if (! x.published_actor)
+    return;
+  auto& st = get(x.source_node);
+  st.actors.emplace(x.published_actor->id(), x.published_actor);
+  auto entry = std::make_pair(x.published_actor, x.port);
+  auto& xs = st.published_actors;
+  if (std::find(xs.begin(), xs.end(), entry) == xs.end())
+    xs.push_back(std::move(entry));
+}
+
+void state_store::update(const traffic_delta& x, uint64_t timestamp) {
+  auto& st = get(x.source_node);
+  accumulate(st.node_traffic_out, st.actor_traffic_out, x);
+  accumulate(st.forwarded, st.route_event_counts, x);
+  // routes without traffic in this delta drop to zero
+  for (auto& kvp : st.rates)
+    kvp.second = route_rates{0, 0, 0};
+  auto last = st.last_traffic;
+  st.last_traffic = timestamp;
+  if (last == 0 || timestamp <= last)
+    return;
+  auto per_sec = 1000.0 / static_cast<double>(timestamp - last);
+  for (auto& y : x.forwarded) {
+    auto& r = st.rates[std::make_pair(y.from, y.to)];
+    r.messages += y.messages * per_sec;
+    r.bytes += y.bytes * per_sec;
+  }
+  for (auto& y : x.events)
+    if (y.kind != remote_actor)
+      st.rates[std::make_pair(y.from, y.to)].failures += y.count * per_sec;
+}
+
+void state_store::update(const event_batch& x) {
+  for (auto& y : x.ram)
+    update(y);
+  for (auto& y : x.load)
+    update(y);
+  for (auto& y : x.routes)
+    update(y);
+  for (auto& y : x.lost_routes)
+    update(y);
+  for (auto& y : x.published_actors)
+    update(y);
+  for (auto& y : x.traffic)
+    update(y);
+  for (auto& y : x.latencies)
+    update(y);
+  for (auto& y : x.hotspots)
+    update(y);
+  for (auto& y : x.threads)
+    update(y);
+}
+
+void state_store::update(state_delta& x) {
+  if (x.reset)
+    clear();
+  for (auto& kvp : x.changed)
+    assign(kvp.first, kvp.second);
+  for (auto& nid : x.removed)
+    erase(nid);
+}
+
+void state_store::assign(probe_data_map& xs) {
+  clear();
+  nodes_.reserve(xs.size());
+  for (auto& kvp : xs)
+    assign(kvp.first, kvp.second);
+}
+
+void state_store::erase(const node_id& nid) {
+  auto i = nodes_.find(nid);
+  if (i == nodes_.end())
+    return;
+  unindex_hostname(nid, i->second.node.hostname);
+  unindex_hot_actors(nid, i->second);
+  nodes_.erase(i);
+}
+
+void state_store::clear() {
+  nodes_.clear();
+  by_hostname_.clear();
+  slowest_.clear();
+}
+
+const state_store::node_state* state_store::find(const node_id& nid) const {
+  auto i = nodes_.find(nid);
+  return i != nodes_.end() ? &i->second : nullptr;
+}
+
+const std::vector<node_id>&
+state_store::nodes(const std::string& hostname) const {
+  static const std::vector<node_id> empty;
+  auto i = by_hostname_.find(hostname);
+  return i != by_hostname_.end() ? i->second : empty;
+}
+
+strong_actor_ptr state_store::find_actor(const node_id& nid,
+                                         actor_id aid) const {
+  auto i = nodes_.find(nid);
+  if (i == nodes_.end())
+    return nullptr;
+  auto j = i->second.actors.find(aid);
+  return j != i->second.actors.end() ? j->second : nullptr;
+}
+
+void state_store::slowest(size_t n,
+                          std::vector<actor_latency>& out) const {
+  for (auto i = slowest_.begin(); i != slowest_.end() && n > 0; ++i, --n) {
+    auto j = nodes_.find(i->second.first);
+    if (j != nodes_.end())
+      out.push_back(j->second.hot_actors[i->second.second]);
+  }
+}
+
+void state_store::collect_routes(const node_id& via,
+                                 std::vector<forwarding_stats>& out) const {
+  auto i = nodes_.find(via);
+  if (i == nodes_.end())
+    return;
+  auto& st = i->second;
+  std::map<std::pair<node_id, node_id>, forwarding_stats> xs;
+  auto get_stats = [&](const node_id& from, const node_id& to)
+                   -> forwarding_stats& {
+    auto j = xs.emplace(std::make_pair(from, to),
+                        forwarding_stats{via, from, to, 0, 0, 0, 0, 0, 0});
+    return j.first->second;
+  };
+  for (auto& kvp : st.forwarded) {
+    auto& x = get_stats(kvp.second.from, kvp.second.to);
+    x.messages = kvp.second.messages;
+    x.bytes = kvp.second.bytes;
+  }
+  for (auto& kvp : st.route_event_counts)
+    if (kvp.second.kind != remote_actor)
+      get_stats(kvp.second.from, kvp.second.to).failures
+        += kvp.second.count;
+  for (auto& kvp : st.rates) {
+    auto& x = get_stats(kvp.first.first, kvp.first.second);
+    x.messages_per_sec = kvp.second.messages;
+    x.bytes_per_sec = kvp.second.bytes;
+    x.failures_per_sec = kvp.second.failures;
+  }
+  for (auto& kvp : xs)
+    out.push_back(kvp.second);
+}
+
+uint64_t state_store::now() {
+  using namespace std::chrono;
+  auto t = system_clock::now().time_since_epoch();
+  return static_cast<uint64_t>(duration_cast<milliseconds>(t).count());
+}
+
+state_store::node_state& state_store::get(const node_id& nid) {
+  // constructing a node_state allocates its history, hence find first
+  auto i = nodes_.find(nid);
+  if (i != nodes_.end())
+    return i->second;
+  // index new nodes under the empty hostname until we receive a node_info
+  by_hostname_[std::string{}].push_back(nid);
+  return nodes_.emplace(std::piecewise_construct, std::forward_as_tuple(nid),
+                        std::forward_as_tuple(history_minutes_,
+                                              history_hours_)).first->second;
+}
+
+void state_store::set_node(const node_id& nid, node_state& st,
+                           node_info x) {
+  if (st.node.hostname != x.hostname) {
+    unindex_hostname(nid, st.node.hostname);
+    by_hostname_[x.hostname].push_back(nid);
+  }
+  st.node = std::move(x);
+}
+
+void state_store::assign(const node_id& nid, probe_data& x) {
+  auto& st = get(nid);
+  set_node(nid, st, std::move(x.node));
+  st.ram = std::move(x.ram);
+  st.load = std::move(x.load);
+  st.routes.assign(x.direct_routes.begin(), x.direct_routes.end());
+  st.published_actors.assign(x.published_actors.begin(),
+                             x.published_actors.end());
+  st.actors.clear();
+  for (auto& addr : x.known_actors)
+    if (addr)
+      st.actors.emplace(addr->id(), addr);
+  st.node_traffic_out = std::move(x.node_traffic_out);
+  st.actor_traffic_out = std::move(x.actor_traffic_out);
+  st.forwarded = std::move(x.forwarded);
+  st.route_event_counts = std::move(x.route_event_counts);
+  st.latencies = std::move(x.latencies);
+  st.threads = std::move(x.threads);
+  set_hot_actors(nid, st, std::move(x.hot_actors));
+}
+
+void state_store::unindex_hostname(const node_id& nid,
+                                   const std::string& hostname) {
+  auto i = by_hostname_.find(hostname);
+  if (i == by_hostname_.end())
+    return;
+  auto& xs = i->second;
+  xs.erase(std::remove(xs.begin(), xs.end(), nid), xs.end());
+  if (xs.empty())
+    by_hostname_.erase(i);
+}
+
+void state_store::set_hot_actors(const node_id& nid, node_state& st,
+                                 std::vector<actor_latency> xs) {
+  unindex_hot_actors(nid, st);
+  st.hot_actors = std::move(xs);
+  for (size_t i = 0; i < st.hot_actors.size(); ++i)
+    slowest_.emplace(st.hot_actors[i].p99, std::make_pair(nid, i));
+}
+
+void state_store::unindex_hot_actors(const node_id& nid,
+                                     const node_state& st) {
+  for (auto& x : st.hot_actors) {
+    auto range = slowest_.equal_range(x.p99);
+    for (auto i = range.first; i != range.second; ++i) {
+      if (i->second.first == nid) {
+        slowest_.erase(i);
+        break;
+      }
+    }
+  }
+}
+
+} // namespace riac
+} // namespace caf
@@ -0,0 +1,89 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2015                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#include "caf/riac/time_series.hpp"
+
+#include <algorithm>
+
+namespace caf {
+namespace riac {
+
+time_series::time_series(size_t raw_size, size_t seconds_size,
+                         size_t minutes_size, size_t hours_size)
+    : levels_{ring_buffer<metric_point>{raw_size},
+              ring_buffer<metric_point>{seconds_size},
+              ring_buffer<metric_point>{minutes_size},
+              ring_buffer<metric_point>{hours_size}},
+      open_() {
+  // nop
+}
+
+void time_series::add(uint64_t timestamp, double value) {
+  metric_point x{timestamp, 1, value, value, value};
+  levels_[raw].push_back(x);
+  for (int i = seconds; i < num_resolutions; ++i) {
+    auto r = static_cast<resolution>(i);
+    auto& y = open_[r];
+    x.timestamp = timestamp - timestamp % width(r);
+    if (y.count > 0 && y.timestamp == x.timestamp) {
+      ++y.count;
+      y.min = std::min(y.min, value);
+      y.max = std::max(y.max, value);
+      y.sum += value;
+      continue;
+    }
+    if (y.count > 0)
+      levels_[r].push_back(y);
+    y = x;
+  }
+}
+
+time_series::resolution time_series::select(uint64_t from) const {
+  for (int i = raw; i < hours; ++i) {
+    auto& xs = levels_[i];
+    // a buffer covers `from` if it did not drop any points yet
+    // or if its oldest point is not newer than `from`
+    if (! xs.full() || xs.front().timestamp <= from)
+      return static_cast<resolution>(i);
+  }
+  return hours;
+}
+
+void time_series::range(uint64_t from, uint64_t to,
+                        std::vector<metric_point>& out) const {
+  range(select(from), from, to, [&](const metric_point& x) {
+    out.push_back(x);
+  });
+}
+
+uint64_t time_series::width(resolution r) {
+  switch (r) {
+    default:
+      return 1;
+    case seconds:
+      return 1000;
+    case minutes:
+      return 60 * 1000;
+    case hours:
+      return 60 * 60 * 1000;
+  }
+}
+
+} // namespace riac
+} // namespace caf
@@ -0,0 +1,199 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2015                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#include "caf/riac/topology.hpp"
+
+#include "caf/config.hpp"
+
+#ifndef CAF_WINDOWS
+#include <sys/utsname.h>
+#endif
+
+#include <map>
+#include <thread>
+#include <fstream>
+#include <sstream>
+#include <cstdlib>
+
+namespace caf {
+namespace riac {
+
+namespace {
+
+#ifdef CAF_LINUX
+
+constexpr const char* sys_cpu_dir = "/sys/devices/system/cpu/";
+
+constexpr const char* sys_node_dir = "/sys/devices/system/node/";
+
+// returns the first line of `path` or an empty string on error
+std::string read_line(const std::string& path) {
+  std::string result;
+  std::ifstream in{path};
+  if (in)
+    std::getline(in, result);
+  return result;
+}
+
+// parses sizes such as "32K" or "8M" in sysfs cache descriptions
+uint64_t parse_size(const std::string& str) {
+  char* pos;
+  auto result = strtoull(str.c_str(), &pos, 10);
+  switch (*pos) {
+    case 'K': return result * 1024;
+    case 'M': return result * 1024 * 1024;
+    case 'G': return result * 1024 * 1024 * 1024;
+    default: return result;
+  }
+}
+
+// maps logical CPU IDs to their frequency as reported in /proc/cpuinfo
+std::map<uint32_t, uint64_t> cpuinfo_mhz() {
+  std::map<uint32_t, uint64_t> result;
+  std::ifstream in{"/proc/cpuinfo"};
+  std::string line;
+  uint32_t cpu = 0;
+  while (std::getline(in, line)) {
+    auto sep = line.find(':');
+    if (sep == std::string::npos)
+      continue;
+    auto value = line.c_str() + sep + 1;
+    if (line.compare(0, 9, "processor") == 0)
+      cpu = static_cast<uint32_t>(strtoul(value, nullptr, 10));
+    else if (line.compare(0, 7, "cpu MHz") == 0)
+      result[cpu] = static_cast<uint64_t>(strtod(value, nullptr));
+  }
+  return result;
+}
+
+// returns the maximum frequency of `cpu`, preferring cpufreq over cpuinfo
+uint64_t mhz(uint32_t cpu, const std::map<uint32_t, uint64_t>& fallback) {
+  std::ostringstream path;
+  path << sys_cpu_dir << "cpu" << cpu << "/cpufreq/cpuinfo_max_freq";
+  auto khz = read_line(path.str());
+  if (! khz.empty())
+    return strtoull(khz.c_str(), nullptr, 10) / 1000;
+  auto i = fallback.find(cpu);
+  return i != fallback.end() ? i->second : 0;
+}
+
+// reads the sizes of L1 data, L2 and L3 cache of `cpu`
+void read_caches(uint32_t cpu, cpu_info& x) {
+  for (int index = 0; ; ++index) {
+    std::ostringstream dir;
+    dir << sys_cpu_dir << "cpu" << cpu << "/cache/index" << index << "/";
+    auto level = read_line(dir.str() + "level");
+    if (level.empty())
+      return;
+    auto type = read_line(dir.str() + "type");
+    if (type == "Instruction")
+      continue;
+    auto size = parse_size(read_line(dir.str() + "size"));
+    switch (level[0]) {
+      case '1': x.l1_cache = size; break;
+      case '2': x.l2_cache = size; break;
+      case '3': x.l3_cache = size; break;
+      default: break;
+    }
+  }
+}
+
+#endif // CAF_LINUX
+
+} // namespace <anonymous>
+
+std::vector<uint32_t> parse_cpu_list(const std::string& str) {
+  std::vector<uint32_t> result;
+  auto pos = str.c_str();
+  char* end;
+  for (;;) {
+    auto first = strtoul(pos, &end, 10);
+    if (end == pos)
+      return result;
+    auto last = first;
+    if (*end == '-') {
+      pos = end + 1;
+      last = strtoul(pos, &end, 10);
+      if (end == pos)
+        return result;
+    }
+    for (auto i = first; i <= last; ++i)
+      result.push_back(static_cast<uint32_t>(i));
+    if (*end != ',')
+      return result;
+    pos = end + 1;
+  }
+}
+
+std::vector<cpu_info> cpu_topology(const node_id& source_node) {
+  std::vector<cpu_info> result;
+#ifdef CAF_LINUX
+  auto fallback = cpuinfo_mhz();
+  auto add = [&](uint32_t numa_node, std::vector<uint32_t> cpus) {
+    if (cpus.empty())
+      return;
+    cpu_info x{};
+    x.source_node = source_node;
+    x.num_cores = cpus.size();
+    uint64_t total_mhz = 0;
+    for (auto cpu : cpus)
+      total_mhz += mhz(cpu, fallback);
+    x.mhz_per_core = total_mhz / cpus.size();
+    x.numa_node = numa_node;
+    read_caches(cpus.front(), x);
+    x.cpus = std::move(cpus);
+    result.push_back(std::move(x));
+  };
+  auto numa_nodes = read_line(std::string{sys_node_dir} + "online");
+  for (auto i : parse_cpu_list(numa_nodes)) {
+    std::ostringstream path;
+    path << sys_node_dir << "node" << i << "/cpulist";
+    add(i, parse_cpu_list(read_line(path.str())));
+  }
+  // kernels without NUMA support have no node directories
+  if (result.empty())
+    add(0, parse_cpu_list(read_line(std::string{sys_cpu_dir} + "online")));
+#endif // CAF_LINUX
+  if (result.empty()) {
+    cpu_info x{};
+    x.source_node = source_node;
+    x.num_cores = std::thread::hardware_concurrency();
+    result.push_back(std::move(x));
+  }
+  return result;
+}
+
+std::string os_version() {
+#ifdef CAF_WINDOWS
+  return "Windows";
+#else
+  utsname buf;
+  if (uname(&buf) != 0)
+    return "";
+  std::string result = buf.sysname;
+  result += ' ';
+  result += buf.release;
+  result += ' ';
+  result += buf.machine;
+  return result;
+#endif
+}
+
+} // namespace riac
+} // namespace caf
@@ -0,0 +1,68 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2015                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#include "caf/riac/trace_rings.hpp"
+
+#include <utility>
+
+namespace caf {
+namespace riac {
+
+namespace {
+
+std::atomic<uint64_t> next_id{1};
+
+} // namespace <anonymous>
+
+trace_rings::trace_rings(size_t ring_size)
+    : id_(next_id++),
+      ring_size_(ring_size > 0 ? ring_size : 1),
+      dropped_(0) {
+  // nop
+}
+
+bool trace_rings::push(new_message&& x) {
+  if (local().push(std::move(x)))
+    return true;
+  dropped_.fetch_add(1, std::memory_order_relaxed);
+  return false;
+}
+
+uint64_t trace_rings::drain(std::vector<new_message>& out) {
+  std::unique_lock<std::mutex> guard{mtx_};
+  for (auto& r : rings_)
+    r->drain([&](new_message&& x) { out.push_back(std::move(x)); });
+  return dropped_.exchange(0, std::memory_order_relaxed);
+}
+
+trace_rings::ring& trace_rings::local() {
+  // IDs are never reused, hence entries of destroyed instances never match
+  thread_local std::vector<std::pair<uint64_t, ring*>> cache;
+  for (auto& x : cache)
+    if (x.first == id_)
+      return *x.second;
+  std::unique_lock<std::mutex> guard{mtx_};
+  rings_.emplace_back(new ring(ring_size_));
+  auto ptr = rings_.back().get();
+  cache.emplace_back(id_, ptr);
+  return *ptr;
+}
+
+} // namespace riac
+} // namespace caf
@@ -0,0 +1,197 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2015                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#include "caf/riac/trace_store.hpp"
+
+#include <algorithm>
+#include <functional>
+
+namespace caf {
+namespace riac {
+
+constexpr uint64_t trace_store::response_flag_mask;
+
+constexpr uint64_t trace_store::request_id_mask;
+
+trace_store::trace_store(size_t max_spans)
+    : max_spans_(max_spans > 0 ? max_spans : 1) {
+  // nop
+}
+
+void trace_store::add(const new_message& x) {
+  auto req = x.mid & request_id_mask;
+  if (req == 0)
+    return;
+  auto response = (x.mid & response_flag_mask) != 0;
+  // the client sends the request and receives the response
+  auto id = response ? span_id(x.dest_node, x.dest_actor, req)
+                     : span_id(x.source_node, x.source_actor, req);
+  auto& s = get(id, x, response);
+  if (! response) {
+    s.type_token = x.type_token;
+    if (x.received) {
+      s.request_received = x.timestamp;
+      if (s.response_sent == 0)
+        active_[actor_key{s.server_node, s.server}].push_back(id);
+    } else {
+      s.request_sent = x.timestamp;
+      if (s.parent_id == 0)
+        link(s);
+    }
+  } else if (x.received) {
+    s.response_received = x.timestamp;
+  } else {
+    s.response_sent = x.timestamp;
+    deactivate(s);
+  }
+  if (spans_.size() > max_spans_)
+    evict();
+}
+
+void trace_store::trace(uint64_t id, std::vector<span_info>& out) const {
+  auto first = out.size();
+  auto range = by_trace_.equal_range(id);
+  for (auto i = range.first; i != range.second; ++i) {
+    auto j = spans_.find(i->second);
+    if (j != spans_.end())
+      out.push_back(j->second);
+  }
+  auto start = [](const span_info& x) {
+    return x.request_sent != 0 ? x.request_sent : x.request_received;
+  };
+  std::sort(out.begin() + static_cast<ptrdiff_t>(first), out.end(),
+            [&](const span_info& x, const span_info& y) {
+              return start(x) < start(y);
+            });
+}
+
+void trace_store::slowest(size_t n, std::vector<span_info>& out) const {
+  std::vector<const span_info*> xs;
+  for (auto& kvp : spans_) {
+    auto& x = kvp.second;
+    if (x.parent_id == 0 && x.request_sent != 0
+        && x.response_received >= x.request_sent)
+      xs.push_back(&x);
+  }
+  auto latency = [](const span_info* x) {
+    return x->response_received - x->request_sent;
+  };
+  n = std::min(n, xs.size());
+  std::partial_sort(xs.begin(), xs.begin() + static_cast<ptrdiff_t>(n),
+                    xs.end(), [&](const span_info* x, const span_info* y) {
+                      return latency(x) > latency(y);
+                    });
+  for (size_t i = 0; i < n; ++i)
+    out.push_back(*xs[i]);
+}
+
+uint64_t trace_store::span_id(const node_id& client_node, actor_id client,
+                              uint64_t request_id) {
+  uint64_t result = std::hash<node_id>{}(client_node);
+  result = result * 31 + client;
+  result = result * 31 + request_id;
+  // 0 denotes "no parent"
+  return result != 0 ? result : 1;
+}
+
+span_info& trace_store::get(uint64_t id, const new_message& x,
+                            bool response) {
+  auto i = spans_.find(id);
+  if (i != spans_.end())
+    return i->second;
+  span_info s;
+  s.trace_id = id;
+  s.span_id = id;
+  s.parent_id = 0;
+  s.client_node = response ? x.dest_node : x.source_node;
+  s.client = response ? x.dest_actor : x.source_actor;
+  s.server_node = response ? x.source_node : x.dest_node;
+  s.server = response ? x.source_actor : x.dest_actor;
+  s.type_token = 0;
+  s.request_sent = 0;
+  s.request_received = 0;
+  s.response_sent = 0;
+  s.response_received = 0;
+  order_.push_back(id);
+  by_trace_.emplace(id, id);
+  return spans_.emplace(id, s).first->second;
+}
+
+void trace_store::link(span_info& x) {
+  auto i = active_.find(actor_key{x.client_node, x.client});
+  if (i == active_.end())
+    return;
+  // the latest request received before sending `x` is the parent
+  auto& xs = i->second;
+  for (auto j = xs.rbegin(); j != xs.rend(); ++j) {
+    auto k = spans_.find(*j);
+    if (k != spans_.end() && k->second.request_received <= x.request_sent
+        && k->second.span_id != x.span_id) {
+      x.parent_id = k->second.span_id;
+      retrace(x.trace_id, k->second.trace_id);
+      return;
+    }
+  }
+}
+
+void trace_store::retrace(uint64_t from, uint64_t to) {
+  if (from == to)
+    return;
+  auto range = by_trace_.equal_range(from);
+  std::vector<uint64_t> ids;
+  for (auto i = range.first; i != range.second; ++i)
+    ids.push_back(i->second);
+  by_trace_.erase(range.first, range.second);
+  for (auto id : ids) {
+    auto i = spans_.find(id);
+    if (i != spans_.end())
+      i->second.trace_id = to;
+    by_trace_.emplace(to, id);
+  }
+}
+
+void trace_store::deactivate(const span_info& x) {
+  auto i = active_.find(actor_key{x.server_node, x.server});
+  if (i == active_.end())
+    return;
+  auto& xs = i->second;
+  xs.erase(std::remove(xs.begin(), xs.end(), x.span_id), xs.end());
+  if (xs.empty())
+    active_.erase(i);
+}
+
+void trace_store::evict() {
+  auto id = order_.front();
+  order_.pop_front();
+  auto i = spans_.find(id);
+  if (i == spans_.end())
+    return;
+  deactivate(i->second);
+  auto range = by_trace_.equal_range(i->second.trace_id);
+  for (auto j = range.first; j != range.second; ++j) {
+    if (j->second == id) {
+      by_trace_.erase(j);
+      break;
+    }
+  }
+  spans_.erase(i);
+}
+
+} // namespace riac
+} // namespace caf
@@ -0,0 +1,340 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2015                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#include "caf/riac/wire_format.hpp"
+
+#include <array>
+#include <tuple>
+#include <cstring>
+
+#include "caf/riac/varint.hpp"
+
+namespace caf {
+namespace riac {
+
+namespace {
+
+// bits in the flags byte of a batch
+constexpr uint8_t reset_flag = 0x01;
+
+// record tags
+enum record_tag : uint8_t {
+  ram_usage_tag = 1,
+  work_load_tag,
+  new_route_tag,
+  new_message_tag,
+  traffic_delta_tag,
+  route_lost_tag
+};
+
+// node references, larger values are indexes offset by `first_node_ref`
+constexpr uint64_t invalid_node_ref = 0;
+constexpr uint64_t new_node_ref = 1;
+constexpr uint64_t first_node_ref = 2;
+
+constexpr size_t host_id_size = std::tuple_size<node_id::host_id_type>::value;
+
+} // namespace <anonymous>
+
+wire_encoder::wire_encoder() : reset_(true) {
+  // nop
+}
+
+void wire_encoder::reset() {
+  ids_.clear();
+  reset_ = true;
+}
+
+compact_batch wire_encoder::encode(event_batch& x) {
+  buf_.clear();
+  buf_.push_back(static_cast<char>(reset_ ? reset_flag : 0));
+  reset_ = false;
+  write(x.dropped);
+  x.dropped = 0;
+  for (auto& y : x.ram) {
+    buf_.push_back(ram_usage_tag);
+    write(y.source_node);
+    write(y.in_use);
+    write(y.available);
+  }
+  x.ram.clear();
+  for (auto& y : x.load) {
+    buf_.push_back(work_load_tag);
+    write(y.source_node);
+    buf_.push_back(static_cast<char>(y.cpu_load));
+    write(y.num_processes);
+    write(y.num_actors);
+  }
+  x.load.clear();
+  for (auto& y : x.routes) {
+    buf_.push_back(new_route_tag);
+    write(y.source_node);
+    write(y.dest);
+    buf_.push_back(y.is_direct ? 1 : 0);
+  }
+  x.routes.clear();
+  for (auto& y : x.lost_routes) {
+    buf_.push_back(route_lost_tag);
+    write(y.source_node);
+    write(y.dest);
+  }
+  x.lost_routes.clear();
+  uint64_t last_ts = 0;
+  auto keep = x.messages.begin();
+  for (auto& y : x.messages) {
+    if (y.msg) {
+      if (&*keep != &y)
+        *keep = std::move(y);
+      ++keep;
+      continue;
+    }
+    buf_.push_back(new_message_tag);
+    write(y.source_node);
+    write(y.dest_node);
+    write(y.source_actor);
+    write(y.dest_actor);
+    write(y.mid);
+    write(y.type_token);
+    write(y.size);
+    buf_.push_back(y.received ? 1 : 0);
+    write(zigzag(static_cast<int64_t>(y.timestamp - last_ts)));
+    last_ts = y.timestamp;
+  }
+  x.messages.erase(keep, x.messages.end());
+  for (auto& y : x.traffic) {
+    buf_.push_back(traffic_delta_tag);
+    write(y.source_node);
+    write(y.dropped);
+    write(y.actors.size());
+    for (auto& z : y.actors) {
+      write(z.source_actor);
+      write(z.dest_node);
+      write(z.dest_actor);
+      write(z.messages);
+      write(z.bytes);
+    }
+    write(y.nodes.size());
+    for (auto& z : y.nodes) {
+      write(z.dest_node);
+      write(z.messages);
+      write(z.bytes);
+    }
+    write(y.forwarded.size());
+    for (auto& z : y.forwarded) {
+      write(z.from);
+      write(z.to);
+      write(z.messages);
+      write(z.bytes);
+    }
+    write(y.events.size());
+    for (auto& z : y.events) {
+      write(z.from);
+      write(z.to);
+      write(z.kind);
+      write(z.count);
+      write(z.bytes);
+    }
+  }
+  x.traffic.clear();
+  return compact_batch{x.source_node, std::move(buf_)};
+}
+
+void wire_encoder::write(uint64_t x) {
+  write_varint(buf_, x);
+}
+
+void wire_encoder::write(const node_id& x) {
+  if (x == invalid_node_id) {
+    write(invalid_node_ref);
+    return;
+  }
+  auto i = ids_.find(x);
+  if (i != ids_.end()) {
+    write(i->second);
+    return;
+  }
+  ids_.emplace(x, first_node_ref + ids_.size());
+  write(new_node_ref);
+  auto pid = x.process_id();
+  for (int n = 0; n < 4; ++n)
+    buf_.push_back(static_cast<char>((pid >> (n * 8)) & 0xFF));
+  auto& hid = x.host_id();
+  buf_.insert(buf_.end(), hid.begin(), hid.end());
+}
+
+bool wire_decoder::decode(const compact_batch& x, event_batch& out) {
+  auto pos = x.data.data();
+  auto last = pos + x.data.size();
+  if (pos == last)
+    return false;
+  if (static_cast<uint8_t>(*pos++) & reset_flag)
+    ids_.clear();
+  out.source_node = x.source_node;
+  if (! read(pos, last, out.dropped))
+    return false;
+  uint64_t last_ts = 0;
+  uint64_t tmp;
+  while (pos != last) {
+    switch (static_cast<uint8_t>(*pos++)) {
+      default:
+        return false;
+      case ram_usage_tag: {
+        ram_usage y;
+        if (! read(pos, last, y.source_node) || ! read(pos, last, y.in_use)
+            || ! read(pos, last, y.available))
+          return false;
+        out.ram.push_back(std::move(y));
+        break;
+      }
+      case work_load_tag: {
+        work_load y;
+        if (! read(pos, last, y.source_node) || pos == last)
+          return false;
+        y.cpu_load = static_cast<uint8_t>(*pos++);
+        if (! read(pos, last, y.num_processes)
+            || ! read(pos, last, y.num_actors))
+          return false;
+        out.load.push_back(std::move(y));
+        break;
+      }
+      case new_route_tag: {
+        new_route y;
+        if (! read(pos, last, y.source_node) || ! read(pos, last, y.dest)
+            || pos == last)
+          return false;
+        y.is_direct = *pos++ != 0;
+        out.routes.push_back(std::move(y));
+        break;
+      }
+      case route_lost_tag: {
+        route_lost y;
+        if (! read(pos, last, y.source_node) || ! read(pos, last, y.dest))
+          return false;
+        out.lost_routes.push_back(std::move(y));
+        break;
+      }
+      case new_message_tag: {
+        new_message y;
+        uint64_t type_token;
+        uint64_t size;
+        if (! read(pos, last, y.source_node) || ! read(pos, last, y.dest_node)
+            || ! read(pos, last, y.source_actor)
+            || ! read(pos, last, y.dest_actor) || ! read(pos, last, y.mid)
+            || ! read(pos, last, type_token) || ! read(pos, last, size)
+            || pos == last)
+          return false;
+        y.received = *pos++ != 0;
+        if (! read(pos, last, tmp))
+          return false;
+        y.type_token = static_cast<uint32_t>(type_token);
+        y.size = static_cast<uint32_t>(size);
+        last_ts += static_cast<uint64_t>(unzigzag(tmp));
+        y.timestamp = last_ts;
+        out.messages.push_back(std::move(y));
+        break;
+      }
+      case traffic_delta_tag: {
+        traffic_delta y;
+        if (! read(pos, last, y.source_node) || ! read(pos, last, y.dropped)
+            || ! read(pos, last, tmp))
+          return false;
+        for (uint64_t i = 0; i < tmp; ++i) {
+          actor_traffic z;
+          z.source_node = y.source_node;
+          if (! read(pos, last, z.source_actor)
+              || ! read(pos, last, z.dest_node)
+              || ! read(pos, last, z.dest_actor)
+              || ! read(pos, last, z.messages) || ! read(pos, last, z.bytes))
+            return false;
+          y.actors.push_back(std::move(z));
+        }
+        if (! read(pos, last, tmp))
+          return false;
+        for (uint64_t i = 0; i < tmp; ++i) {
+          node_traffic z;
+          z.source_node = y.source_node;
+          if (! read(pos, last, z.dest_node) || ! read(pos, last, z.messages)
+              || ! read(pos, last, z.bytes))
+            return false;
+          y.nodes.push_back(std::move(z));
+        }
+        if (! read(pos, last, tmp))
+          return false;
+        for (uint64_t i = 0; i < tmp; ++i) {
+          forwarding_traffic z;
+          z.source_node = y.source_node;
+          if (! read(pos, last, z.from) || ! read(pos, last, z.to)
+              || ! read(pos, last, z.messages) || ! read(pos, last, z.bytes))
+            return false;
+          y.forwarded.push_back(std::move(z));
+        }
+        if (! read(pos, last, tmp))
+          return false;
+        for (uint64_t i = 0; i < tmp; ++i) {
+          route_events z;
+          uint64_t kind;
+          z.source_node = y.source_node;
+          if (! read(pos, last, z.from) || ! read(pos, last, z.to)
+              || ! read(pos, last, kind) || ! read(pos, last, z.count)
+              || ! read(pos, last, z.bytes))
+            return false;
+          z.kind = static_cast<uint32_t>(kind);
+          y.events.push_back(std::move(z));
+        }
+        out.traffic.push_back(std::move(y));
+        break;
+      }
+    }
+  }
+  return true;
+}
+
+bool wire_decoder::read(const char*& pos, const char* last, uint64_t& x) {
+  return read_varint(pos, last, x);
+}
+
+bool wire_decoder::read(const char*& pos, const char* last, node_id& x) {
+  uint64_t ref;
+  if (! read(pos, last, ref))
+    return false;
+  if (ref == invalid_node_ref) {
+    x = invalid_node_id;
+    return true;
+  }
+  if (ref == new_node_ref) {
+    if (static_cast<size_t>(last - pos) < 4 + host_id_size)
+      return false;
+    uint32_t pid = 0;
+    for (int n = 0; n < 4; ++n)
+      pid |= static_cast<uint32_t>(static_cast<uint8_t>(*pos++)) << (n * 8);
+    node_id::host_id_type hid;
+    memcpy(hid.data(), pos, host_id_size);
+    pos += host_id_size;
+    x = node_id{pid, hid};
+    ids_.push_back(x);
+    return true;
+  }
+  if (ref - first_node_ref >= ids_.size())
+    return false;
+  x = ids_[ref - first_node_ref];
+  return true;
+}
+
+} // namespace riac
+} // namespace caf
@@ -0,0 +1,108 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2015                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#include "caf/config.hpp"
+
+#define CAF_SUITE coalescer
+#include "caf/test/unit_test.hpp"
+
+#include <vector>
+
+#include "caf/riac/coalescer.hpp"
+
+#include "test_helpers.hpp"
+
+using namespace caf;
+using namespace caf::riac;
+
+namespace {
+
+std::vector<event_batch> flush(coalescer& c) {
+  std::vector<event_batch> result;
+  c.flush([&](event_batch& x) {
+    result.push_back(x);
+  });
+  return result;
+}
+
+} // namespace <anonymous>
+
+CAF_TEST(marks_dirty_nodes) {
+  auto n1 = make_node(1);
+  auto n2 = make_node(2);
+  coalescer c;
+  CAF_CHECK(flush(c).empty());
+  c.add(ram_usage{n1, 1, 10});
+  c.add(work_load{n1, 50, 1, 2});
+  c.add(thread_load{n2, 4, {}});
+  CAF_CHECK_EQUAL(c.size(), 2u);
+  // a single batch per node with all of its updates
+  auto xs = flush(c);
+  CAF_REQUIRE_EQUAL(xs.size(), 2u);
+  auto& x = xs[0].source_node == n1 ? xs[0] : xs[1];
+  auto& y = xs[0].source_node == n1 ? xs[1] : xs[0];
+  CAF_CHECK(x.source_node == n1);
+  CAF_CHECK_EQUAL(x.dropped, 0u);
+  CAF_CHECK_EQUAL(x.ram.size(), 1u);
+  CAF_CHECK_EQUAL(x.load.size(), 1u);
+  CAF_CHECK(x.threads.empty());
+  CAF_CHECK(y.source_node == n2);
+  CAF_CHECK(y.ram.empty() && y.load.empty());
+  CAF_CHECK_EQUAL(y.threads.size(), 1u);
+  // flushing clears all dirty nodes
+  CAF_CHECK_EQUAL(c.size(), 0u);
+  CAF_CHECK(flush(c).empty());
+}
+
+CAF_TEST(latest_value_wins) {
+  auto n1 = make_node(1);
+  coalescer c;
+  c.add(ram_usage{n1, 1, 10});
+  c.add(ram_usage{n1, 2, 10});
+  c.add(work_load{n1, 10, 1, 2});
+  c.add(ram_usage{n1, 3, 10});
+  c.add(work_load{n1, 20, 1, 2});
+  auto xs = flush(c);
+  CAF_REQUIRE_EQUAL(xs.size(), 1u);
+  CAF_REQUIRE_EQUAL(xs[0].ram.size(), 1u);
+  CAF_CHECK_EQUAL(xs[0].ram[0].in_use, 3u);
+  CAF_REQUIRE_EQUAL(xs[0].load.size(), 1u);
+  CAF_CHECK_EQUAL(xs[0].load[0].cpu_load, 20);
+}
+
+CAF_TEST(drops_disconnected_nodes) {
+  auto n1 = make_node(1);
+  auto n2 = make_node(2);
+  coalescer c;
+  c.add(ram_usage{n1, 1, 10});
+  c.add(ram_usage{n2, 1, 10});
+  c.erase(n1);
+  c.erase(make_node(3));
+  auto xs = flush(c);
+  CAF_REQUIRE_EQUAL(xs.size(), 1u);
+  CAF_CHECK(xs[0].source_node == n2);
+  // a node reconnecting in the same interval starts with an empty batch
+  c.add(ram_usage{n1, 1, 10});
+  c.erase(n1);
+  c.add(work_load{n1, 10, 1, 2});
+  xs = flush(c);
+  CAF_REQUIRE_EQUAL(xs.size(), 1u);
+  CAF_CHECK(xs[0].ram.empty());
+  CAF_CHECK_EQUAL(xs[0].load.size(), 1u);
+}
@@ -0,0 +1,103 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2015                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#include "caf/config.hpp"
+
+#define CAF_SUITE credit_split
+#include "caf/test/unit_test.hpp"
+
+#include <set>
+#include <vector>
+#include <numeric>
+
+#include "caf/riac/credit_split.hpp"
+
+using namespace caf;
+using namespace caf::riac;
+
+namespace {
+
+using split = credit_split<int>;
+
+uint32_t sum(const std::vector<uint32_t>& xs) {
+  return std::accumulate(xs.begin(), xs.end(), 0u);
+}
+
+// returns the shard that received a single credit
+size_t receiver(const std::vector<uint32_t>& xs) {
+  for (size_t i = 0; i < xs.size(); ++i)
+    if (xs[i] == 1)
+      return i;
+  CAF_FAIL("no shard received credit");
+  return xs.size();
+}
+
+} // namespace <anonymous>
+
+CAF_TEST(even_split_without_events) {
+  split s{4};
+  auto xs = s.split(1, 8);
+  CAF_REQUIRE_EQUAL(xs.size(), 4u);
+  for (auto x : xs)
+    CAF_CHECK_EQUAL(x, 2u);
+}
+
+CAF_TEST(rotation_per_listener) {
+  split s{4};
+  std::set<size_t> first;
+  std::set<size_t> second;
+  // interleaved grants must not skip shards for either listener
+  for (int i = 0; i < 4; ++i) {
+    first.insert(receiver(s.split(1, 1)));
+    second.insert(receiver(s.split(2, 1)));
+  }
+  CAF_CHECK_EQUAL(first.size(), 4u);
+  CAF_CHECK_EQUAL(second.size(), 4u);
+}
+
+CAF_TEST(busy_shard) {
+  split s{4};
+  s.count(0, 1000);
+  // an even split would leave the listener with 2 credits for all events
+  // of shard 0, while the idle shards sit on the remaining 6 credits
+  auto xs = s.split(1, 8);
+  CAF_CHECK_EQUAL(sum(xs), 8u);
+  CAF_CHECK_EQUAL(xs[0], 5u);
+  // idle shards keep a share for listeners that only select their nodes
+  for (size_t i = 1; i < xs.size(); ++i)
+    CAF_CHECK_EQUAL(xs[i], 1u);
+}
+
+CAF_TEST(recent_events_dominate) {
+  split s{4};
+  s.count(0, 1000);
+  s.count(1, 2 * split::window);
+  auto xs = s.split(1, 8);
+  CAF_CHECK_EQUAL(sum(xs), 8u);
+  CAF_CHECK(xs[1] > xs[0]);
+  CAF_CHECK(xs[0] >= xs[2]);
+}
+
+CAF_TEST(erase_restarts_rotation) {
+  split s{4};
+  CAF_CHECK_EQUAL(receiver(s.split(1, 1)), 0u);
+  CAF_CHECK_EQUAL(receiver(s.split(1, 1)), 1u);
+  s.erase(1);
+  CAF_CHECK_EQUAL(receiver(s.split(1, 1)), 0u);
+}
@@ -0,0 +1,186 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2015                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#include "caf/config.hpp"
+
+#define CAF_SUITE export_format
+#include "caf/test/unit_test.hpp"
+
+#include <string>
+#include <cstdio>
+#include <fstream>
+
+#include "caf/riac/export_format.hpp"
+
+#include "test_helpers.hpp"
+
+using namespace caf;
+using namespace caf::riac;
+
+namespace {
+
+new_message make_message(const node_id& src, const node_id& dest,
+                         uint64_t mid, uint64_t timestamp) {
+  new_message x;
+  x.source_node = src;
+  x.dest_node = dest;
+  x.source_actor = 1;
+  x.dest_actor = 2;
+  x.mid = mid;
+  x.type_token = 3;
+  x.size = 100;
+  x.timestamp = timestamp;
+  x.received = mid % 2 == 0;
+  return x;
+}
+
+// adds 10 messages and one RAM usage report to `out`
+void write_events(export_writer& out, const node_id& n1, const node_id& n2) {
+  for (uint64_t i = 0; i < 10; ++i)
+    out.add(make_message(n1, n2, i, 1000 + i * 10));
+  out.add(500, ram_usage{n2, 10, 20});
+}
+
+} // namespace <anonymous>
+
+CAF_TEST(schema) {
+  CAF_CHECK_EQUAL(column_count(export_table::messages), 9u);
+  CAF_CHECK_EQUAL(column_count(export_table::nodes), 0u);
+  CAF_CHECK_EQUAL(std::string{column_name(export_table::ram, 0)}, "time");
+  CAF_CHECK_EQUAL(std::string{column_name(export_table::ram, 3)},
+                  "available");
+  CAF_CHECK(column_name(export_table::ram, 4) == nullptr);
+}
+
+CAF_TEST(indexed_file) {
+  auto path = std::string{"riac_export_test.bin"};
+  auto n1 = make_node(1);
+  auto n2 = make_node(2);
+  { // scope for the writer
+    export_writer out{path, 0, 0, 4};
+    write_events(out, n1, n2);
+  }
+  export_reader in;
+  CAF_REQUIRE(in.open(path));
+  // 10 messages in blocks of 4 plus one RAM block
+  auto& blocks = in.blocks();
+  CAF_REQUIRE_EQUAL(blocks.size(), 4u);
+  CAF_CHECK(blocks[0].table == export_table::messages);
+  CAF_CHECK_EQUAL(blocks[0].rows, 4u);
+  CAF_CHECK_EQUAL(blocks[0].min_time, 1000u);
+  CAF_CHECK_EQUAL(blocks[0].max_time, 1030u);
+  CAF_CHECK(blocks[3].table == export_table::ram);
+  export_block x;
+  // read only time and mid of the last message block
+  CAF_REQUIRE(in.read(blocks[2], x, 0x21));
+  CAF_CHECK_EQUAL(x.rows, 2u);
+  CAF_REQUIRE_EQUAL(x.columns.size(), 9u);
+  CAF_CHECK(x.columns[1].empty());
+  CAF_CHECK_EQUAL(x.columns[0][1], 1090u);
+  CAF_CHECK_EQUAL(x.columns[5][1], 9u);
+  CAF_REQUIRE(in.read(blocks[3], x));
+  CAF_CHECK(in.node(x.columns[1][0]) == n2);
+  CAF_CHECK_EQUAL(x.columns[2][0], 10u);
+  CAF_CHECK_EQUAL(x.columns[3][0], 20u);
+  // sequential reading returns the same blocks in order
+  size_t rows = 0;
+  while (in.next(x))
+    rows += x.rows;
+  CAF_CHECK_EQUAL(rows, 11u);
+  std::remove(path.c_str());
+}
+
+CAF_TEST(unfinished_file) {
+  auto path = std::string{"riac_export_test.bin"};
+  auto n1 = make_node(1);
+  auto n2 = make_node(2);
+  export_writer out{path, 0, 0, 4};
+  write_events(out, n1, n2);
+  CAF_REQUIRE(out.flush());
+  // without an index, the reader scans all blocks
+  export_reader in;
+  CAF_REQUIRE(in.open(path));
+  CAF_REQUIRE_EQUAL(in.blocks().size(), 4u);
+  export_block x;
+  CAF_REQUIRE(in.read(in.blocks()[0], x));
+  CAF_CHECK(in.node(x.columns[1][0]) == n1);
+  CAF_CHECK(in.node(x.columns[2][0]) == n2);
+  CAF_CHECK_EQUAL(x.columns[8][0], 1u);
+  CAF_CHECK_EQUAL(x.columns[8][1], 0u);
+  out.close();
+  std::remove(path.c_str());
+}
+
+CAF_TEST(rotation) {
+  auto path = std::string{"riac_export_test"};
+  auto n1 = make_node(1);
+  auto n2 = make_node(2);
+  { // scope for the writer
+    export_writer out{path, 1, 2, 4};
+    for (int i = 0; i < 3; ++i) {
+      write_events(out, n1, n2);
+      CAF_CHECK(out.flush());
+    }
+    CAF_CHECK_EQUAL(out.current_file(), path + ".3");
+  }
+  CAF_CHECK(! std::ifstream{path + ".0"});
+  export_reader in;
+  // each file carries its own node IDs
+  for (auto i : {1, 2}) {
+    CAF_REQUIRE(in.open(path + "." + std::to_string(i)));
+    CAF_CHECK_EQUAL(in.blocks().size(), 4u);
+    export_block x;
+    CAF_REQUIRE(in.read(in.blocks()[3], x));
+    CAF_CHECK(in.node(x.columns[1][0]) == n2);
+    std::remove((path + "." + std::to_string(i)).c_str());
+  }
+}
+
+CAF_TEST(restart_continues_rotation) {
+  auto path = std::string{"riac_export_test"};
+  auto file = [&](int i) {
+    return path + "." + std::to_string(i);
+  };
+  auto n1 = make_node(1);
+  auto n2 = make_node(2);
+  // left over from a previous run with a larger `max_files`
+  std::ofstream{file(0)} << "stale";
+  { // scope for the writer
+    export_writer out{path, 1, 2, 4};
+    for (int i = 0; i < 2; ++i) {
+      write_events(out, n1, n2);
+      CAF_CHECK(out.flush());
+    }
+  }
+  CAF_CHECK(! std::ifstream{file(0)});
+  CAF_CHECK(std::ifstream{file(1)});
+  CAF_CHECK(std::ifstream{file(2)});
+  { // the second run must not overwrite the files of the first one
+    export_writer out{path, 1, 2, 4};
+    CAF_CHECK_EQUAL(out.current_file(), file(3));
+    write_events(out, n1, n2);
+    CAF_CHECK(out.flush());
+  }
+  CAF_CHECK(! std::ifstream{file(1)});
+  export_reader in;
+  for (auto i : {2, 3}) {
+    CAF_CHECK(in.open(file(i)));
+    std::remove(file(i).c_str());
+  }
+}
@@ -0,0 +1,133 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2015                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#include "caf/config.hpp"
+
+#define CAF_SUITE flow_control
+#include "caf/test/unit_test.hpp"
+
+#include <vector>
+
+#include "caf/riac/flow_control.hpp"
+
+#include "test_helpers.hpp"
+
+using namespace caf;
+using namespace caf::riac;
+
+namespace {
+
+using flow = flow_control<int>;
+
+// delivers `x` from `nid` like the nexus does, returns whether the
+// listener received it right away
+bool deliver(flow& f, const node_id& nid, int x, bool& keep) {
+  if (f.consume())
+    return true;
+  keep = f.hold(nid, [=] { return x; });
+  return false;
+}
+
+bool deliver(flow& f, const node_id& nid, int x) {
+  auto keep = true;
+  auto result = deliver(f, nid, x, keep);
+  CAF_CHECK(keep);
+  return result;
+}
+
+} // namespace <anonymous>
+
+CAF_TEST(credit_limits_deliveries) {
+  auto n1 = make_node(1);
+  flow f{drop_oldest_policy, 2, 10};
+  CAF_CHECK(deliver(f, n1, 1));
+  CAF_CHECK(deliver(f, n1, 2));
+  CAF_CHECK(! deliver(f, n1, 3));
+  CAF_CHECK_EQUAL(f.credit(), 0u);
+  CAF_CHECK_EQUAL(f.queued(), 1u);
+  CAF_CHECK_EQUAL(f.dropped(), 0u);
+}
+
+CAF_TEST(drop_oldest) {
+  auto n1 = make_node(1);
+  flow f{drop_oldest_policy, 0, 2};
+  for (int i = 1; i <= 4; ++i)
+    CAF_CHECK(! deliver(f, n1, i));
+  CAF_CHECK_EQUAL(f.queued(), 2u);
+  CAF_CHECK_EQUAL(f.dropped(), 2u);
+  std::vector<int> sent;
+  auto no_chunks = [](const std::vector<node_id>&, bool) {
+    CAF_CHECK(false);
+  };
+  f.grant(1, 10, [&](int x) { sent.push_back(x); }, no_chunks);
+  CAF_CHECK_EQUAL(sent.size(), 1u);
+  CAF_CHECK_EQUAL(sent.front(), 3);
+  // queued events go first, new events must not overtake them
+  f.grant(5, 10, [&](int x) { sent.push_back(x); }, no_chunks);
+  CAF_CHECK_EQUAL(sent.size(), 2u);
+  CAF_CHECK_EQUAL(sent.back(), 4);
+  CAF_CHECK_EQUAL(f.credit(), 4u);
+  CAF_CHECK(deliver(f, n1, 5));
+  CAF_CHECK_EQUAL(f.credit(), 3u);
+}
+
+CAF_TEST(coalesce) {
+  auto n1 = make_node(1);
+  auto n2 = make_node(2);
+  auto n3 = make_node(3);
+  flow f{coalesce_policy, 0, 10};
+  CAF_CHECK(! deliver(f, n1, 1));
+  CAF_CHECK(! deliver(f, n2, 2));
+  CAF_CHECK(! deliver(f, n1, 3));
+  CAF_CHECK(! deliver(f, n3, 4));
+  CAF_CHECK_EQUAL(f.queued(), 0u);
+  CAF_CHECK_EQUAL(f.dropped(), 4u);
+  std::vector<std::vector<node_id>> chunks;
+  std::vector<bool> last;
+  auto no_events = [](int) {
+    CAF_CHECK(false);
+  };
+  auto collect = [&](const std::vector<node_id>& xs, bool is_last) {
+    chunks.push_back(xs);
+    last.push_back(is_last);
+  };
+  // each chunk costs one credit and holds up to two nodes
+  f.grant(1, 2, no_events, collect);
+  CAF_CHECK_EQUAL(chunks.size(), 1u);
+  CAF_CHECK_EQUAL(chunks[0].size(), 2u);
+  CAF_CHECK(! last[0]);
+  CAF_CHECK_EQUAL(f.credit(), 0u);
+  f.grant(3, 2, no_events, collect);
+  CAF_CHECK_EQUAL(chunks.size(), 2u);
+  CAF_CHECK_EQUAL(chunks[1].size(), 1u);
+  CAF_CHECK(last[1]);
+  CAF_CHECK_EQUAL(f.credit(), 2u);
+  CAF_CHECK(deliver(f, n1, 5));
+}
+
+CAF_TEST(disconnect) {
+  auto n1 = make_node(1);
+  flow f{disconnect_policy, 1, 10};
+  CAF_CHECK(deliver(f, n1, 1));
+  auto keep = true;
+  CAF_CHECK(! deliver(f, n1, 2, keep));
+  CAF_CHECK(! keep);
+  CAF_CHECK_EQUAL(f.dropped(), 1u);
+  CAF_CHECK_EQUAL(f.queued(), 0u);
+}
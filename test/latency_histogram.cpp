@@ -0,0 +1,77 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2015                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#include "caf/config.hpp"
+
+#define CAF_SUITE latency_histogram
+#include "caf/test/unit_test.hpp"
+
+#include <vector>
+
+#include "caf/riac/latency_histogram.hpp"
+
+using namespace caf::riac;
+
+CAF_TEST(bucket_bounds) {
+  for (size_t i = 0; i < latency_histogram::num_buckets; ++i) {
+    auto lb = latency_histogram::lower_bound(i);
+    CAF_CHECK_EQUAL(latency_histogram::bucket(lb), i);
+    if (i + 1 < latency_histogram::num_buckets) {
+      auto ub = latency_histogram::upper_bound(i);
+      CAF_CHECK_EQUAL(latency_histogram::bucket(ub), i);
+      CAF_CHECK_EQUAL(ub + 1, latency_histogram::lower_bound(i + 1));
+    }
+  }
+  CAF_CHECK_EQUAL(latency_histogram::bucket(3), 3u);
+  CAF_CHECK_EQUAL(latency_histogram::bucket(4), 4u);
+  CAF_CHECK_EQUAL(latency_histogram::bucket(13), 10u);
+  CAF_CHECK_EQUAL(latency_histogram::bucket(uint64_t{1} << 40),
+                  latency_histogram::num_buckets - 1);
+}
+
+CAF_TEST(percentiles) {
+  latency_histogram h;
+  CAF_CHECK_EQUAL(h.percentile(50), 0u);
+  for (uint64_t i = 1; i <= 100; ++i)
+    h.record(i);
+  CAF_CHECK_EQUAL(h.count(), 100u);
+  CAF_CHECK_EQUAL(h.max(), 100u);
+  // 50 falls into the bucket [48, 55]
+  CAF_CHECK_EQUAL(h.percentile(50), 55u);
+  // 99 falls into the bucket [96, 111], capped by the maximum
+  CAF_CHECK_EQUAL(h.percentile(99), 100u);
+  CAF_CHECK_EQUAL(h.percentile(100), 100u);
+}
+
+CAF_TEST(counts) {
+  latency_histogram h;
+  h.record(1);
+  h.record(1);
+  h.record(5);
+  std::vector<uint64_t> xs;
+  h.counts(xs);
+  CAF_REQUIRE_EQUAL(xs.size(), 6u);
+  CAF_CHECK_EQUAL(xs[1], 2u);
+  CAF_CHECK_EQUAL(xs[5], 1u);
+  h.clear();
+  xs.clear();
+  h.counts(xs);
+  CAF_CHECK(xs.empty());
+  CAF_CHECK_EQUAL(h.count(), 0u);
+}
@@ -0,0 +1,75 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2015                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#include "caf/config.hpp"
+
+#define CAF_SUITE metrics_cache
+#include "caf/test/unit_test.hpp"
+
+#include <string>
+
+#include "caf/riac/metrics_cache.hpp"
+
+#include "test_helpers.hpp"
+
+using namespace caf;
+using namespace caf::riac;
+
+namespace {
+
+bool contains(const std::string& str, const std::string& what) {
+  return str.find(what) != std::string::npos;
+}
+
+} // namespace <anonymous>
+
+CAF_TEST(empty_state) {
+  metrics_cache cache;
+  probe_data_map data;
+  auto& body = cache.render(data);
+  CAF_CHECK(contains(body, "# TYPE riac_cpu_load_percent gauge\n"));
+  CAF_CHECK(! contains(body, "riac_cpu_load_percent{"));
+}
+
+CAF_TEST(per_node_invalidation) {
+  metrics_cache cache;
+  probe_data_map data;
+  auto n1 = make_node(1);
+  auto& x = data[n1];
+  x.version = 1;
+  x.node.hostname = "a\"b";
+  x.ram = ram_usage{n1, 10, 20};
+  auto body = cache.render(data);
+  CAF_CHECK_EQUAL(cache.size(), 1u);
+  CAF_CHECK(contains(body, "host=\"a\\\"b\"} 10\n"));
+  CAF_CHECK(contains(body, "riac_direct_routes{"));
+  // metrics without data are omitted
+  CAF_CHECK(! contains(body, "riac_cpu_load_percent{"));
+  // modifications without new version are not rendered
+  x.ram = ram_usage{n1, 30, 20};
+  CAF_CHECK_EQUAL(cache.render(data), body);
+  x.version = 2;
+  body = cache.render(data);
+  CAF_CHECK(contains(body, "host=\"a\\\"b\"} 30\n"));
+  // removed nodes disappear
+  data.erase(n1);
+  body = cache.render(data);
+  CAF_CHECK_EQUAL(cache.size(), 0u);
+  CAF_CHECK(! contains(body, "riac_direct_routes{"));
+}
@@ -0,0 +1,198 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2015                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#include <map>
+#include <chrono>
+
+#include "caf/config.hpp"
+
+#define CAF_SUITE regional_nexus
+#include "caf/test/unit_test.hpp"
+
+#include "caf/all.hpp"
+#include "caf/riac/all.hpp"
+
+#include "test_helpers.hpp"
+
+using namespace caf;
+using namespace caf::riac;
+
+namespace {
+
+constexpr size_t num_nodes = 8;
+
+// receives a full state transfer from a sharded nexus and counts how often
+// each node occurs in it, a node reported by two shards occurs twice
+std::map<node_id, size_t> transfer(scoped_actor& self,
+                                   const nexus_type& front) {
+  std::map<node_id, size_t> result;
+  self->send(front, add_atom::value, self);
+  auto done = false;
+  while (! done)
+    self->receive(
+      [&](state_delta& x) {
+        for (auto& kvp : x.changed)
+          ++result[kvp.first];
+        // the front sends an empty chunk once all shards are done
+        done = x.last && ! x.reset && x.changed.empty();
+      },
+      after(std::chrono::seconds(5)) >> [&] {
+        CAF_FAIL("timeout while waiting for the state transfer");
+      }
+    );
+  return result;
+}
+
+// spawns a sharded nexus with a regional nexus in front of it and calls
+// `f` with a probe, the regional nexus and a registered listener
+template <class F>
+void with_region(riac::config& cfg, F f) {
+  actor_system system{cfg};
+  scoped_actor self{system};
+  auto front = system.spawn<sharded_nexus>(true, 4);
+  auto region = system.spawn<regional_nexus>(true, front);
+  scoped_actor listener{system};
+  CAF_CHECK(transfer(listener, front).empty());
+  f(self, region, listener);
+  anon_send_exit(region, exit_reason::kill);
+  anon_send_exit(front, exit_reason::kill);
+}
+
+new_message make_trace(const node_id& nid, uint64_t mid) {
+  new_message x;
+  x.source_node = nid;
+  x.dest_node = nid;
+  x.source_actor = 1;
+  x.dest_actor = 2;
+  x.mid = mid;
+  x.type_token = 0;
+  x.size = 0;
+  x.timestamp = mid;
+  x.received = false;
+  return x;
+}
+
+void run(bool compact) {
+  riac::config cfg;
+  cfg.riac.region_interval = 10;
+  cfg.riac.compact_wire = compact;
+  actor_system system{cfg};
+  scoped_actor self{system};
+  auto front = system.spawn<sharded_nexus>(true, 4);
+  auto region = system.spawn<regional_nexus>(true, front);
+  scoped_actor listener{system};
+  CAF_CHECK(transfer(listener, front).empty());
+  // the scoped actor acts as the probe of all nodes in the region
+  for (uint32_t i = 0; i < num_nodes; ++i) {
+    auto nid = make_node(i + 1, 0x10);
+    self->send(region, node_info{nid});
+    self->send(region, ram_usage{nid, 1024, 4096});
+    self->send(region, work_load{nid, 1, 2, 3});
+  }
+  // wait until all nodes arrived at the front with their RAM usage
+  size_t received = 0;
+  while (received < num_nodes)
+    listener->receive(
+      [&](const ram_usage&) {
+        ++received;
+      },
+      [](const node_info&) {
+        // nop
+      },
+      after(std::chrono::seconds(5)) >> [&] {
+        CAF_FAIL("timeout while waiting for ram_usage events");
+      }
+    );
+  auto nodes = transfer(self, front);
+  CAF_CHECK_EQUAL(nodes.size(), num_nodes);
+  for (auto& kvp : nodes)
+    CAF_CHECK_EQUAL(kvp.second, 1u);
+  anon_send_exit(region, exit_reason::kill);
+  anon_send_exit(front, exit_reason::kill);
+}
+
+} // namespace <anonymous>
+
+CAF_TEST(regional_in_front_of_sharded_nexus) {
+  run(false);
+}
+
+CAF_TEST(compact_regional_in_front_of_sharded_nexus) {
+  run(true);
+}
+
+CAF_TEST(bounded_traces) {
+  riac::config cfg;
+  cfg.riac.region_interval = 10;
+  cfg.riac.region_max_messages = 2;
+  with_region(cfg, [](scoped_actor& self, const regional_nexus_type& region,
+                      scoped_actor& listener) {
+    auto nid = make_node(1, 0x10);
+    self->send(region, node_info{nid});
+    for (uint64_t i = 0; i < 5; ++i)
+      self->send(region, make_trace(nid, i));
+    // the region forwards two traces per interval and drops the rest
+    size_t received = 0;
+    auto done = false;
+    while (! done)
+      listener->receive(
+        [&](const new_message&) {
+          ++received;
+        },
+        [](const node_info&) {
+          // nop
+        },
+        after(std::chrono::milliseconds(200)) >> [&] {
+          done = true;
+        }
+      );
+    CAF_CHECK_EQUAL(received, 2u);
+  });
+}
+
+CAF_TEST(lost_routes_in_summary) {
+  riac::config cfg;
+  cfg.riac.region_interval = 10;
+  with_region(cfg, [](scoped_actor& self, const regional_nexus_type& region,
+                      scoped_actor& listener) {
+    auto nid = make_node(1, 0x10);
+    auto peer = make_node(2, 0x10);
+    self->send(region, node_info{nid});
+    self->send(region, new_route{nid, peer, true});
+    auto lost = false;
+    while (! lost)
+      listener->receive(
+        [&](const new_route& x) {
+          CAF_CHECK(x.dest == peer);
+          // the route must arrive in an earlier summary than its loss
+          self->send(region, route_lost{nid, peer});
+        },
+        [&](const route_lost& x) {
+          CAF_CHECK(x.dest == peer);
+          lost = true;
+        },
+        [](const node_info&) {
+          // nop
+        },
+        after(std::chrono::seconds(5)) >> [&] {
+          CAF_FAIL("timeout while waiting for route_lost");
+        }
+      );
+  });
+}
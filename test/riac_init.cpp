@@ -17,6 +17,8 @@
  * http://www.boost.org/LICENSE_1_0.txt.                                      *
  ******************************************************************************/
 
+#include <chrono>
+#include <thread>
 #include <iostream>
 
 #include "caf/config.hpp"
@@ -42,9 +44,11 @@ void run_probe(int argc, char** argv, uint16_t port) {
      .load<riac::probe>();
   actor_system system{cfg};
   CAF_REQUIRE(system.node() != invalid_node_id);
+  // system connects to the nexus in the background after startup (ctor),
+  // then closes the connection on shutdown (dtor)
+  for (int i = 0; i < 100 && ! system.probe().connected(); ++i)
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
   CAF_REQUIRE(system.probe().connected());
-  // system connects to the node during startup (ctor),
-  // then closes it on shutdown (dtor)
 }
 
 void run_nexus(int argc, char** argv) {
@@ -0,0 +1,73 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2015                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#include "caf/config.hpp"
+
+#define CAF_SUITE sampler
+#include "caf/test/unit_test.hpp"
+
+#include "caf/riac/sampler.hpp"
+
+using namespace caf;
+using namespace caf::riac;
+
+namespace {
+
+size_t count_selected(sampler& s, actor_id dest, size_t n,
+                      sampler::clock_type::time_point t) {
+  size_t result = 0;
+  for (size_t i = 0; i < n; ++i)
+    if (s.select(dest, t))
+      ++result;
+  return result;
+}
+
+} // namespace <anonymous>
+
+CAF_TEST(one_in_n) {
+  sampler s{10, 0, {}};
+  auto t = sampler::clock_type::now();
+  CAF_CHECK_EQUAL(count_selected(s, 1, 100, t), 10u);
+  CAF_CHECK_EQUAL(s.dropped(), 90u);
+}
+
+CAF_TEST(per_actor_rates) {
+  sampler s{1, 0, sampler::parse_rates("42=4,43=50")};
+  auto t = sampler::clock_type::now();
+  CAF_CHECK_EQUAL(count_selected(s, 1, 100, t), 100u);
+  CAF_CHECK_EQUAL(count_selected(s, 42, 100, t), 25u);
+  CAF_CHECK_EQUAL(count_selected(s, 43, 100, t), 2u);
+}
+
+CAF_TEST(token_bucket) {
+  sampler s{1, 100, {}};
+  auto t = sampler::clock_type::now() + std::chrono::seconds(1);
+  CAF_CHECK_EQUAL(count_selected(s, 1, 500, t), 100u);
+  t += std::chrono::milliseconds(500);
+  CAF_CHECK_EQUAL(count_selected(s, 1, 500, t), 50u);
+}
+
+CAF_TEST(parse_rates) {
+  auto xs = sampler::parse_rates("1=2,3=4");
+  CAF_CHECK_EQUAL(xs.size(), 2u);
+  CAF_CHECK_EQUAL(xs[1], 2u);
+  CAF_CHECK_EQUAL(xs[3], 4u);
+  CAF_CHECK(sampler::parse_rates("").empty());
+  CAF_CHECK_EQUAL(sampler::parse_rates("1=2,garbage").size(), 1u);
+}
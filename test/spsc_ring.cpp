@@ -0,0 +1,59 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2015                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#include "caf/config.hpp"
+
+#define CAF_SUITE spsc_ring
+#include "caf/test/unit_test.hpp"
+
+#include <thread>
+#include <vector>
+
+#include "caf/riac/spsc_ring.hpp"
+
+using namespace caf::riac;
+
+CAF_TEST(capacity) {
+  spsc_ring<int> r{5};
+  CAF_CHECK_EQUAL(r.capacity(), 8u);
+  for (int i = 0; i < 8; ++i)
+    CAF_CHECK(r.push(int{i}));
+  CAF_CHECK(! r.push(8));
+  std::vector<int> xs;
+  CAF_CHECK_EQUAL(r.drain([&](int x) { xs.push_back(x); }), 8u);
+  CAF_CHECK_EQUAL(xs.front(), 0);
+  CAF_CHECK_EQUAL(xs.back(), 7);
+  CAF_CHECK(r.push(8));
+}
+
+CAF_TEST(concurrent_fifo) {
+  spsc_ring<int> r{64};
+  const int n = 100000;
+  std::thread producer{[&] {
+    for (int i = 0; i < n; ++i)
+      while (! r.push(int{i}))
+        std::this_thread::yield();
+  }};
+  int expected = 0;
+  bool in_order = true;
+  while (expected < n)
+    r.drain([&](int x) { in_order = in_order && x == expected++; });
+  producer.join();
+  CAF_CHECK(in_order);
+}
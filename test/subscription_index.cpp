@@ -0,0 +1,112 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2015                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#include "caf/config.hpp"
+
+#define CAF_SUITE subscription_index
+#include "caf/test/unit_test.hpp"
+
+#include <vector>
+
+#include "caf/riac/subscription_index.hpp"
+
+using namespace caf;
+using namespace caf::riac;
+
+namespace {
+
+using index_type = subscription_index<int>;
+
+std::vector<int> visit(const index_type& idx, uint32_t flag,
+                       const node_id& nid,
+                       std::initializer_list<actor_id> aids = {}) {
+  std::vector<int> result;
+  idx.visit(flag, nid, aids, [&](int hdl) { result.push_back(hdl); });
+  std::sort(result.begin(), result.end());
+  return result;
+}
+
+} // namespace <anonymous>
+
+CAF_TEST(glob_match) {
+  CAF_CHECK(glob_match("", ""));
+  CAF_CHECK(glob_match("*", "worker-1"));
+  CAF_CHECK(glob_match("worker-?", "worker-1"));
+  CAF_CHECK(glob_match("w*-1", "worker-1"));
+  CAF_CHECK(glob_match("*er*1", "worker-1"));
+  CAF_CHECK(! glob_match("worker-?", "worker-10"));
+  CAF_CHECK(! glob_match("db*", "worker-1"));
+}
+
+CAF_TEST(event_types) {
+  index_type idx;
+  subscription all;
+  subscription ram;
+  ram.events = ram_usage_events;
+  CAF_CHECK(idx.add(1, all));
+  CAF_CHECK(idx.add(2, ram));
+  CAF_CHECK(! idx.add(2, all));
+  CAF_CHECK(visit(idx, ram_usage_events, node_id{})
+            == std::vector<int>({1, 2}));
+  CAF_CHECK(visit(idx, work_load_events, node_id{}) == std::vector<int>({1}));
+  CAF_CHECK(visit(idx, route_stats_events, node_id{})
+            == std::vector<int>({1}));
+  CAF_CHECK(idx.erase(1));
+  CAF_CHECK(visit(idx, work_load_events, node_id{}).empty());
+  CAF_CHECK_EQUAL(idx.size(), 1u);
+}
+
+CAF_TEST(nodes_and_hostnames) {
+  index_type idx;
+  node_id n1{1};
+  node_id n2{2};
+  subscription by_id;
+  by_id.nodes.insert(n1);
+  subscription by_name;
+  by_name.hostname_pattern = "db-*";
+  idx.add(1, by_id);
+  idx.add(2, by_name);
+  CAF_CHECK(visit(idx, ram_usage_events, n1) == std::vector<int>({1}));
+  CAF_CHECK(visit(idx, ram_usage_events, n2).empty());
+  idx.add_node(n2, "db-7");
+  CAF_CHECK(visit(idx, ram_usage_events, n2) == std::vector<int>({2}));
+  CAF_CHECK(idx.selects(2, n2));
+  CAF_CHECK(! idx.selects(1, n2));
+  // late subscribers match known hostnames as well
+  idx.add(3, by_name);
+  CAF_CHECK(visit(idx, ram_usage_events, n2) == std::vector<int>({2, 3}));
+  // removing a node keeps explicitly selected IDs
+  idx.add_node(n1, "app-1");
+  idx.remove_node(n1);
+  idx.remove_node(n2);
+  CAF_CHECK(visit(idx, ram_usage_events, n1) == std::vector<int>({1}));
+  CAF_CHECK(visit(idx, ram_usage_events, n2).empty());
+}
+
+CAF_TEST(actors) {
+  index_type idx;
+  subscription sub;
+  sub.actors.insert(42);
+  idx.add(1, sub);
+  CAF_CHECK(visit(idx, new_message_events, node_id{}, {1, 42})
+            == std::vector<int>({1}));
+  CAF_CHECK(visit(idx, new_message_events, node_id{}, {1, 2}).empty());
+  // events without actors are not affected by the actor filter
+  CAF_CHECK(visit(idx, ram_usage_events, node_id{}) == std::vector<int>({1}));
+}
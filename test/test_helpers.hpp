@@ -0,0 +1,41 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2015                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#ifndef CAF_RIAC_TEST_HELPERS_HPP
+#define CAF_RIAC_TEST_HELPERS_HPP
+
+#include <cstdint>
+
+#include "caf/node_id.hpp"
+
+namespace caf {
+namespace riac {
+
+/// Returns a node ID for process `pid` on the host with all bytes of its
+/// host ID set to `host`.
+inline node_id make_node(uint32_t pid, uint8_t host = 1) {
+  node_id::host_id_type hid;
+  hid.fill(host);
+  return node_id{pid, hid};
+}
+
+} // namespace riac
+} // namespace caf
+
+#endif // CAF_RIAC_TEST_HELPERS_HPP
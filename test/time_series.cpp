@@ -0,0 +1,100 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2015                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#include "caf/config.hpp"
+
+#define CAF_SUITE time_series
+#include "caf/test/unit_test.hpp"
+
+#include <vector>
+
+#include "caf/riac/time_series.hpp"
+
+using namespace caf::riac;
+
+namespace {
+
+std::vector<metric_point> range(const time_series& ts,
+                                time_series::resolution r,
+                                uint64_t from, uint64_t to) {
+  std::vector<metric_point> result;
+  ts.range(r, from, to, [&](const metric_point& x) { result.push_back(x); });
+  return result;
+}
+
+} // namespace <anonymous>
+
+CAF_TEST(ring_buffer_wraparound) {
+  ring_buffer<int> xs{3};
+  for (int i = 1; i <= 5; ++i)
+    xs.push_back(i);
+  CAF_CHECK(xs.full());
+  CAF_CHECK_EQUAL(xs.size(), 3u);
+  CAF_CHECK_EQUAL(xs.front(), 3);
+  CAF_CHECK_EQUAL(xs[1], 4);
+  CAF_CHECK_EQUAL(xs.back(), 5);
+}
+
+CAF_TEST(raw_samples) {
+  time_series ts{4, 4, 4, 4};
+  for (uint64_t i = 0; i < 6; ++i)
+    ts.add(i * 100, static_cast<double>(i));
+  // the two oldest samples got overwritten
+  auto xs = range(ts, time_series::raw, 0, 1000);
+  CAF_REQUIRE_EQUAL(xs.size(), 4u);
+  CAF_CHECK_EQUAL(xs.front().timestamp, 200u);
+  CAF_CHECK_EQUAL(xs.back().timestamp, 500u);
+  xs = range(ts, time_series::raw, 300, 400);
+  CAF_REQUIRE_EQUAL(xs.size(), 2u);
+  CAF_CHECK_EQUAL(xs[0].min, 3.);
+  CAF_CHECK_EQUAL(xs[1].max, 4.);
+}
+
+CAF_TEST(rollups) {
+  time_series ts{4, 4, 4, 4};
+  ts.add(1000, 1.);
+  ts.add(1500, 3.);
+  ts.add(2100, 5.);
+  auto xs = range(ts, time_series::seconds, 0, 10000);
+  CAF_REQUIRE_EQUAL(xs.size(), 2u);
+  CAF_CHECK_EQUAL(xs[0].timestamp, 1000u);
+  CAF_CHECK_EQUAL(xs[0].count, 2u);
+  CAF_CHECK_EQUAL(xs[0].min, 1.);
+  CAF_CHECK_EQUAL(xs[0].max, 3.);
+  CAF_CHECK_EQUAL(xs[0].sum, 4.);
+  // the current second is still open
+  CAF_CHECK_EQUAL(xs[1].timestamp, 2000u);
+  CAF_CHECK_EQUAL(xs[1].count, 1u);
+  // rollups overlapping the start of the range are included
+  CAF_CHECK_EQUAL(range(ts, time_series::seconds, 1999, 10000).size(), 2u);
+  xs = range(ts, time_series::minutes, 0, 10000);
+  CAF_REQUIRE_EQUAL(xs.size(), 1u);
+  CAF_CHECK_EQUAL(xs[0].count, 3u);
+}
+
+CAF_TEST(select_resolution) {
+  time_series ts{4, 4, 4, 4};
+  CAF_CHECK_EQUAL(ts.select(0), time_series::raw);
+  for (uint64_t i = 0; i < 10; ++i)
+    ts.add(i * 1000, 1.);
+  // raw samples only reach back to 6s, seconds to 5s
+  CAF_CHECK_EQUAL(ts.select(7000), time_series::raw);
+  CAF_CHECK_EQUAL(ts.select(5000), time_series::seconds);
+  CAF_CHECK_EQUAL(ts.select(0), time_series::minutes);
+}
@@ -0,0 +1,105 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2015                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#include "caf/config.hpp"
+
+#define CAF_SUITE trace_store
+#include "caf/test/unit_test.hpp"
+
+#include <vector>
+
+#include "caf/riac/trace_store.hpp"
+
+#include "test_helpers.hpp"
+
+using namespace caf;
+using namespace caf::riac;
+
+namespace {
+
+constexpr uint64_t response = trace_store::response_flag_mask;
+
+// reports `mid` from `src` to `dest` as seen by both ends
+void hop(trace_store& store, const node_id& src, actor_id src_actor,
+         const node_id& dest, actor_id dest_actor, uint64_t mid,
+         uint64_t sent, uint64_t received) {
+  new_message x;
+  x.source_node = src;
+  x.dest_node = dest;
+  x.source_actor = src_actor;
+  x.dest_actor = dest_actor;
+  x.mid = mid;
+  x.type_token = 0;
+  x.size = 0;
+  x.timestamp = sent;
+  x.received = false;
+  store.add(x);
+  x.timestamp = received;
+  x.received = true;
+  store.add(x);
+}
+
+} // namespace <anonymous>
+
+CAF_TEST(nested_requests) {
+  auto n1 = make_node(1);
+  auto n2 = make_node(2);
+  auto n3 = make_node(3);
+  trace_store store;
+  // actor 1 on n1 asks actor 2 on n2, which asks actor 3 on n3 first
+  hop(store, n1, 1, n2, 2, 7, 100, 110);
+  hop(store, n2, 2, n3, 3, 4, 120, 130);
+  hop(store, n3, 3, n2, 2, 4 | response, 180, 190);
+  hop(store, n2, 2, n1, 1, 7 | response, 200, 215);
+  CAF_CHECK_EQUAL(store.size(), 2u);
+  std::vector<span_info> roots;
+  store.slowest(10, roots);
+  CAF_REQUIRE_EQUAL(roots.size(), 1u);
+  auto& root = roots.front();
+  CAF_CHECK_EQUAL(root.span_id, trace_store::span_id(n1, 1, 7));
+  CAF_CHECK_EQUAL(root.request_received, 110u);
+  CAF_CHECK_EQUAL(root.response_sent, 200u);
+  std::vector<span_info> xs;
+  store.trace(root.trace_id, xs);
+  CAF_REQUIRE_EQUAL(xs.size(), 2u);
+  CAF_CHECK_EQUAL(xs[0].span_id, root.span_id);
+  CAF_CHECK_EQUAL(xs[1].parent_id, root.span_id);
+  CAF_CHECK_EQUAL(xs[1].server, 3u);
+  CAF_CHECK_EQUAL(xs[1].response_received - xs[1].request_sent, 70u);
+}
+
+CAF_TEST(async_messages_are_ignored) {
+  trace_store store;
+  hop(store, make_node(1), 1, make_node(2), 2, 0, 100, 110);
+  CAF_CHECK_EQUAL(store.size(), 0u);
+}
+
+CAF_TEST(eviction) {
+  auto n1 = make_node(1);
+  auto n2 = make_node(2);
+  trace_store store{2};
+  for (uint64_t i = 1; i <= 3; ++i)
+    hop(store, n1, 1, n2, 2, i, i * 100, i * 100 + 10);
+  CAF_CHECK_EQUAL(store.size(), 2u);
+  std::vector<span_info> xs;
+  store.trace(trace_store::span_id(n1, 1, 1), xs);
+  CAF_CHECK(xs.empty());
+  store.trace(trace_store::span_id(n1, 1, 3), xs);
+  CAF_CHECK_EQUAL(xs.size(), 1u);
+}
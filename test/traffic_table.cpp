@@ -0,0 +1,108 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2015                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#include "caf/config.hpp"
+
+#define CAF_SUITE traffic_table
+#include "caf/test/unit_test.hpp"
+
+#include <map>
+#include <thread>
+#include <vector>
+
+#include "caf/riac/traffic_table.hpp"
+
+using namespace caf::riac;
+
+namespace {
+
+using table = traffic_table<int>;
+
+std::map<int, std::pair<uint64_t, uint64_t>> collect(table& t) {
+  std::map<int, std::pair<uint64_t, uint64_t>> result;
+  t.collect([&](int key, uint64_t messages, uint64_t bytes) {
+    result[key] = std::make_pair(messages, bytes);
+  });
+  return result;
+}
+
+} // namespace <anonymous>
+
+CAF_TEST(deltas) {
+  table t{8};
+  t.add(1, 10);
+  t.add(1, 20);
+  t.add(2, 5);
+  auto xs = collect(t);
+  CAF_CHECK_EQUAL(xs.size(), 2u);
+  CAF_CHECK_EQUAL(xs[1].first, 2u);
+  CAF_CHECK_EQUAL(xs[1].second, 30u);
+  CAF_CHECK_EQUAL(xs[2].first, 1u);
+  CAF_CHECK_EQUAL(xs[2].second, 5u);
+  // counters are reset after collecting them
+  CAF_CHECK(collect(t).empty());
+  t.add(2, 7);
+  xs = collect(t);
+  CAF_CHECK_EQUAL(xs.size(), 1u);
+  CAF_CHECK_EQUAL(xs[2].second, 7u);
+}
+
+CAF_TEST(overflow) {
+  table t{2};
+  CAF_CHECK(t.add(1, 1));
+  CAF_CHECK(t.add(2, 1));
+  CAF_CHECK(! t.add(3, 1));
+  CAF_CHECK(t.add(1, 1));
+  CAF_CHECK_EQUAL(t.collect([](int, uint64_t, uint64_t) {}), 1u);
+}
+
+CAF_TEST(idle_keys_release_their_slots) {
+  table t{2};
+  CAF_CHECK(t.add(1, 1));
+  CAF_CHECK(t.add(2, 1));
+  collect(t);
+  // both generations start empty after collecting them
+  CAF_CHECK(t.add(3, 1));
+  CAF_CHECK(t.add(4, 1));
+  collect(t);
+  CAF_CHECK(t.add(5, 1));
+  CAF_CHECK(t.add(6, 1));
+  auto xs = collect(t);
+  CAF_CHECK_EQUAL(xs.size(), 2u);
+  CAF_CHECK_EQUAL(xs.count(5), 1u);
+  CAF_CHECK_EQUAL(t.collect([](int, uint64_t, uint64_t) {}), 0u);
+}
+
+CAF_TEST(concurrent_writers) {
+  table t{64};
+  std::vector<std::thread> workers;
+  for (int i = 0; i < 4; ++i)
+    workers.emplace_back([&] {
+      for (int j = 0; j < 10000; ++j)
+        t.add(j % 16, 1);
+    });
+  for (auto& w : workers)
+    w.join();
+  auto xs = collect(t);
+  CAF_CHECK_EQUAL(xs.size(), 16u);
+  uint64_t total = 0;
+  for (auto& x : xs)
+    total += x.second.first;
+  CAF_CHECK_EQUAL(total, 40000u);
+}
@@ -0,0 +1,140 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2015                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#include "caf/config.hpp"
+
+#define CAF_SUITE wire_format
+#include "caf/test/unit_test.hpp"
+
+#include "caf/riac/wire_format.hpp"
+
+#include "test_helpers.hpp"
+
+using namespace caf;
+using namespace caf::riac;
+
+namespace {
+
+event_batch make_batch(const node_id& n1, const node_id& n2) {
+  event_batch x;
+  x.source_node = n1;
+  x.dropped = 3;
+  x.ram.push_back(ram_usage{n1, 1024, 4096});
+  x.load.push_back(work_load{n1, 42, 100, 7});
+  x.routes.push_back(new_route{n1, n2, true});
+  x.lost_routes.push_back(route_lost{n1, n1});
+  new_message msg;
+  msg.source_node = n1;
+  msg.dest_node = n2;
+  msg.source_actor = 1;
+  msg.dest_actor = 2;
+  msg.mid = 0;
+  msg.type_token = 0xFFFFFFFF;
+  msg.size = 300;
+  msg.timestamp = 1000000;
+  msg.received = false;
+  x.messages.push_back(msg);
+  msg.timestamp = 999990;
+  msg.received = true;
+  x.messages.push_back(msg);
+  traffic_delta td;
+  td.source_node = n1;
+  td.dropped = 7;
+  td.actors.push_back(actor_traffic{n1, 1, n2, 2, 10, 3000});
+  td.nodes.push_back(node_traffic{n1, n2, 10, 3000});
+  td.forwarded.push_back(forwarding_traffic{n1, n2, n1, 5, 500});
+  td.events.push_back(route_events{n1, n1, n2, sending_failed, 2, 64});
+  x.traffic.push_back(td);
+  return x;
+}
+
+} // namespace <anonymous>
+
+CAF_TEST(round_trip) {
+  auto n1 = make_node(10, 1);
+  auto n2 = make_node(20, 2);
+  wire_encoder enc;
+  wire_decoder dec;
+  auto x = make_batch(n1, n2);
+  auto cb = enc.encode(x);
+  // all events have a compact representation
+  CAF_CHECK(x.ram.empty() && x.load.empty() && x.routes.empty());
+  CAF_CHECK(x.lost_routes.empty());
+  CAF_CHECK(x.messages.empty() && x.traffic.empty());
+  event_batch y;
+  CAF_REQUIRE(dec.decode(cb, y));
+  CAF_CHECK_EQUAL(y.dropped, 3u);
+  CAF_REQUIRE_EQUAL(y.ram.size(), 1u);
+  CAF_CHECK(y.ram[0].source_node == n1);
+  CAF_CHECK_EQUAL(y.ram[0].available, 4096u);
+  CAF_REQUIRE_EQUAL(y.load.size(), 1u);
+  CAF_CHECK_EQUAL(y.load[0].cpu_load, 42);
+  CAF_REQUIRE_EQUAL(y.routes.size(), 1u);
+  CAF_CHECK(y.routes[0].dest == n2);
+  CAF_REQUIRE_EQUAL(y.lost_routes.size(), 1u);
+  CAF_CHECK(y.lost_routes[0].dest == n1);
+  CAF_REQUIRE_EQUAL(y.messages.size(), 2u);
+  CAF_CHECK_EQUAL(y.messages[0].type_token, 0xFFFFFFFFu);
+  CAF_CHECK_EQUAL(y.messages[0].timestamp, 1000000u);
+  CAF_CHECK_EQUAL(y.messages[1].timestamp, 999990u);
+  CAF_CHECK(! y.messages[0].received);
+  CAF_CHECK(y.messages[1].received);
+  CAF_REQUIRE_EQUAL(y.traffic.size(), 1u);
+  CAF_CHECK_EQUAL(y.traffic[0].dropped, 7u);
+  CAF_REQUIRE_EQUAL(y.traffic[0].actors.size(), 1u);
+  CAF_CHECK(y.traffic[0].actors[0].source_node == n1);
+  CAF_CHECK_EQUAL(y.traffic[0].actors[0].bytes, 3000u);
+  CAF_REQUIRE_EQUAL(y.traffic[0].nodes.size(), 1u);
+  CAF_CHECK(y.traffic[0].nodes[0].dest_node == n2);
+  CAF_REQUIRE_EQUAL(y.traffic[0].forwarded.size(), 1u);
+  CAF_CHECK(y.traffic[0].forwarded[0].from == n2);
+  CAF_CHECK_EQUAL(y.traffic[0].forwarded[0].bytes, 500u);
+  CAF_REQUIRE_EQUAL(y.traffic[0].events.size(), 1u);
+  CAF_CHECK_EQUAL(y.traffic[0].events[0].kind,
+                  static_cast<uint32_t>(sending_failed));
+  CAF_CHECK_EQUAL(y.traffic[0].events[0].count, 2u);
+}
+
+CAF_TEST(node_interning) {
+  auto n1 = make_node(10, 1);
+  auto n2 = make_node(20, 2);
+  wire_encoder enc;
+  wire_decoder dec;
+  auto x = make_batch(n1, n2);
+  auto first = enc.encode(x);
+  x = make_batch(n1, n2);
+  auto second = enc.encode(x);
+  // node IDs are sent in full only once
+  CAF_CHECK(second.data.size() < first.data.size());
+  event_batch y;
+  CAF_REQUIRE(dec.decode(first, y));
+  y = event_batch{};
+  CAF_REQUIRE(dec.decode(second, y));
+  CAF_CHECK(y.routes[0].source_node == n1);
+  CAF_CHECK(y.routes[0].dest == n2);
+  // a new session requires sending node IDs again
+  wire_decoder fresh;
+  CAF_CHECK(! fresh.decode(second, y));
+  enc.reset();
+  x = make_batch(n1, n2);
+  auto third = enc.encode(x);
+  y = event_batch{};
+  CAF_REQUIRE(fresh.decode(third, y));
+  CAF_CHECK(y.ram[0].source_node == n1);
+}